@@ -1,6 +1,13 @@
 #include "ast.hh"
 #include "driver.hh"
+#include "interp.hh"
+#include "tiered.hh"
+#include "runtime/kalrt.h"
+#include <algorithm>
+#include <cmath>
 #include <exception>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/MDBuilder.h>
 
 /* CONSTRUCTORS IMPLEMENTATIONS */
 
@@ -9,12 +16,14 @@ VariableExprAST::VariableExprAST(
       const location& loc)
   : ExprAST(loc),
     name(name) {}
+const std::string& VariableExprAST::getName() const { return name; }
 
 NumberExprAST::NumberExprAST(
       double value, 
       const location& loc)
   : ExprAST(loc),
   value(value) {}
+double NumberExprAST::getValue() const { return value; }
 
 BinaryExprAST::BinaryExprAST(
       BinaryOperator op,
@@ -25,6 +34,9 @@ BinaryExprAST::BinaryExprAST(
     op(op),
     lhs(std::move(lhs)),
     rhs(std::move(rhs)) {}
+BinaryOperator BinaryExprAST::getOp() const { return op; }
+ExprAST* BinaryExprAST::getLHS() const { return lhs.get(); }
+ExprAST* BinaryExprAST::getRHS() const { return rhs.get(); }
 
 UnaryExprAST::UnaryExprAST(
       UnaryOperator op,
@@ -53,12 +65,17 @@ SequenceAST::SequenceAST(
 FunctionPrototypeAST::FunctionPrototypeAST(
       const std::string &name,
       std::vector<std::string> argsNames,
-      const location& loc)
+      const location& loc,
+      std::vector<bool> arrayArgs)
   : RootAST(loc),
     name(name),
-    argsNames(argsNames) {}
+    argsNames(argsNames),
+    arrayArgs(std::move(arrayArgs)) {}
 
 const std::string& FunctionPrototypeAST::getName() const { return name; }
+const std::vector<std::string>& FunctionPrototypeAST::getArgsNames() const { return argsNames; }
+bool FunctionPrototypeAST::isArrayArg(size_t i) const { return i < arrayArgs.size() && arrayArgs[i]; }
+bool FunctionPrototypeAST::hasArrayArgs() const { return std::find(arrayArgs.begin(), arrayArgs.end(), true) != arrayArgs.end(); }
 
 FunctionAST::FunctionAST(
       std::unique_ptr<FunctionPrototypeAST> prototype,
@@ -67,6 +84,7 @@ FunctionAST::FunctionAST(
   : RootAST(loc),
     prototype(std::move(prototype)),
     body(std::move(body)) {}
+const std::string& FunctionAST::getName() const { return prototype->getName(); }
 
 IfExprAST::IfExprAST(
       std::unique_ptr<ExprAST> cond_expr,
@@ -90,21 +108,25 @@ ForExprAST::ForExprAST(
       std::unique_ptr<AssignmentExprAST> init_expr,
       std::unique_ptr<ExprAST> cond_expr,
       std::unique_ptr<AssignmentExprAST>  step_expr,
+      LoopPragmas pragmas,
       std::unique_ptr<ExprAST> body_expr,
       const location& loc)
   : ExprAST(loc),
     init_expr(std::move(init_expr)),
-    cond_expr(std::move(cond_expr)),
     step_expr(std::move(step_expr)),
-    body_expr(std::move(body_expr)) {}
+    cond_expr(std::move(cond_expr)),
+    body_expr(std::move(body_expr)),
+    pragmas(pragmas) {}
 
 WhileExprAST::WhileExprAST(
       std::unique_ptr<ExprAST> cond_expr,
+      LoopPragmas pragmas,
       std::unique_ptr<ExprAST> body_expr,
       const location& loc)
   : ExprAST(loc),
     cond_expr(std::move(cond_expr)),
-    body_expr(std::move(body_expr)) {}
+    body_expr(std::move(body_expr)),
+    pragmas(pragmas) {}
 
 AssignmentExprAST::AssignmentExprAST(
       std::string id_name,
@@ -114,6 +136,7 @@ AssignmentExprAST::AssignmentExprAST(
     id_name(id_name),
     value_expr(std::move(value_expr)) {}
 const std::string& AssignmentExprAST::getDestinationName() const { return id_name; }
+ExprAST* AssignmentExprAST::getValue() const { return value_expr.get(); }
 
 VarExprAST::VarExprAST(
       std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> declarations,
@@ -123,19 +146,176 @@ VarExprAST::VarExprAST(
     declarations(std::move(declarations)),
     body(std::move(body)) {}
 
+NewArrayExprAST::NewArrayExprAST(
+      uint64_t size,
+      const location& loc)
+  : ExprAST(loc),
+    size(size) {}
+uint64_t NewArrayExprAST::getSize() const { return size; }
+
+ArrayIndexExprAST::ArrayIndexExprAST(
+      const std::string &name,
+      std::unique_ptr<ExprAST> index_expr,
+      const location& loc)
+  : ExprAST(loc),
+    name(name),
+    index_expr(std::move(index_expr)) {}
+
+ArrayAssignExprAST::ArrayAssignExprAST(
+      const std::string &name,
+      std::unique_ptr<ExprAST> index_expr,
+      std::unique_ptr<ExprAST> value_expr,
+      const location& loc)
+  : ExprAST(loc),
+    name(name),
+    index_expr(std::move(index_expr)),
+    value_expr(std::move(value_expr)) {}
+
+ArrayLengthExprAST::ArrayLengthExprAST(
+      const std::string &name,
+      const location& loc)
+  : ExprAST(loc),
+    name(name) {}
+const std::string& ArrayLengthExprAST::getName() const { return name; }
+
+
+/* CALL GRAPH */
+
+void BinaryExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->lhs->collectCallees(callees);
+  this->rhs->collectCallees(callees);
+}
+
+void UnaryExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->operand->collectCallees(callees);
+}
+
+void CallExprAST::collectCallees(std::vector<std::string>& callees) {
+  callees.push_back(this->callee);
+  for (auto& arg : this->args)
+    arg->collectCallees(callees);
+}
+
+void IfExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->cond_expr->collectCallees(callees);
+  this->then_expr->collectCallees(callees);
+  this->else_expr->collectCallees(callees);
+}
+
+void CompositeExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->current->collectCallees(callees);
+  if (this->next)
+    this->next->collectCallees(callees);
+}
+
+void AssignmentExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->value_expr->collectCallees(callees);
+}
+
+void ForExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->init_expr->collectCallees(callees);
+  this->cond_expr->collectCallees(callees);
+  this->step_expr->collectCallees(callees);
+  this->body_expr->collectCallees(callees);
+}
+
+void WhileExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->cond_expr->collectCallees(callees);
+  this->body_expr->collectCallees(callees);
+}
+
+void VarExprAST::collectCallees(std::vector<std::string>& callees) {
+  for (auto &decl : this->declarations)
+    decl.second->collectCallees(callees);
+  this->body->collectCallees(callees);
+}
+
+void FunctionAST::collectCallees(std::vector<std::string>& callees) {
+  this->body->collectCallees(callees);
+}
+
+void ArrayIndexExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->index_expr->collectCallees(callees);
+}
+
+void ArrayAssignExprAST::collectCallees(std::vector<std::string>& callees) {
+  this->index_expr->collectCallees(callees);
+  this->value_expr->collectCallees(callees);
+}
+
+
+/* ASSIGNMENTS */
+
+bool BinaryExprAST::assigns(const std::string& name) {
+  return this->lhs->assigns(name) || this->rhs->assigns(name);
+}
+
+bool UnaryExprAST::assigns(const std::string& name) {
+  return this->operand->assigns(name);
+}
+
+bool CallExprAST::assigns(const std::string& name) {
+  for (auto& arg : this->args)
+    if (arg->assigns(name))
+      return true;
+  return false;
+}
+
+bool IfExprAST::assigns(const std::string& name) {
+  return this->cond_expr->assigns(name) || this->then_expr->assigns(name) || this->else_expr->assigns(name);
+}
+
+bool CompositeExprAST::assigns(const std::string& name) {
+  return this->current->assigns(name) || (this->next && this->next->assigns(name));
+}
+
+bool AssignmentExprAST::assigns(const std::string& name) {
+  return this->id_name == name || this->value_expr->assigns(name);
+}
+
+bool ForExprAST::assigns(const std::string& name) {
+  return this->init_expr->assigns(name) || this->cond_expr->assigns(name) || this->step_expr->assigns(name) || this->body_expr->assigns(name);
+}
+
+bool WhileExprAST::assigns(const std::string& name) {
+  return this->cond_expr->assigns(name) || this->body_expr->assigns(name);
+}
+
+bool VarExprAST::assigns(const std::string& name) {
+  for (auto &decl : this->declarations)
+    if (decl.second->assigns(name))
+      return true;
+  return this->body->assigns(name);
+}
+
+bool ArrayIndexExprAST::assigns(const std::string& name) {
+  return this->index_expr->assigns(name);
+}
+
+bool ArrayAssignExprAST::assigns(const std::string& name) {
+  return this->index_expr->assigns(name) || this->value_expr->assigns(name);
+}
+
 
 /* CODE GENERATION */
-typedef yy::position position;
-static inline std::string posToStrVerbose(const position& pos) {
+static inline std::string posToStrVerbose(const SourcePosition& pos) {
   return "Ln " + std::to_string(pos.line) + " Col " + std::to_string(pos.column);
 }
 
-static inline std::string posToStrCompact(const position& pos) {
+static inline std::string posToStrCompact(const SourcePosition& pos) {
   return "{" + std::to_string(pos.line) + ", " + std::to_string(pos.column) + "}";
 }
 
+codegen_error::codegen_error(const location& loc, const std::string& message)
+  : std::runtime_error(message),
+    loc(loc) {}
+
+std::string codegen_error::describe(const driver& drv) const {
+  return "Error at " + posToStrVerbose(drv.lines.resolve(loc.begin)) + ": " + what();
+}
+
 static inline void error(const location& loc, const std::string& message) {
-  throw "Error at " + posToStrVerbose(loc.begin) + ": " + message;
+  throw codegen_error(loc, message);
 }
 
 static inline void dbglog(const driver& drv, const std::string& construct, const std::string& str, int depth, const location& loc) {
@@ -145,7 +325,7 @@ static inline void dbglog(const driver& drv, const std::string& construct, const
       llvm::errs() << " \"" << str << "\"";
     llvm::errs() << "]  ";
 
-    llvm::errs() << "From " << posToStrCompact(loc.begin) << " to " << posToStrCompact(loc.end) << "\n";
+    llvm::errs() << "From " << posToStrCompact(drv.lines.resolve(loc.begin)) << " to " << posToStrCompact(drv.lines.resolve(loc.end)) << "\n";
   }
 }
 
@@ -156,7 +336,7 @@ static llvm::AllocaInst* createAllocaInEntryBlock(const driver& drv, llvm::Funct
 }
 
 static llvm::AllocaInst* createVar(driver& drv, llvm::Function* F, const std::string& name, const location& loc, llvm::Value* initValue = nullptr) {
-  if (drv.namedPointers[name])
+  if (drv.namedPointers[name] || drv.namedArrays.count(name))
     error(loc, "Redefinition of variable " + name);
 
   llvm::AllocaInst* ptr = createAllocaInEntryBlock(drv, F, name);
@@ -171,11 +351,111 @@ static llvm::AllocaInst* createVar(driver& drv, llvm::Function* F, const std::st
 
 static llvm::AllocaInst* getVar(driver& drv, const location& loc, const std::string& name) {
   llvm::AllocaInst* ptr = drv.namedPointers[name];
+  if (!ptr && drv.namedArrays.count(name))
+    error(loc, "Array " + name + " used as a number");
   if (!ptr)
     error(loc, "Unknown variable name: " + name);
   return ptr;
 }
 
+// Continue in a new block if ok holds, trap otherwise.
+static void createCheck(driver& drv, llvm::Value* ok) {
+  llvm::Function* F = drv.llvmIRBuilder->GetInsertBlock()->getParent();
+  llvm::BasicBlock* okBB = llvm::BasicBlock::Create(*drv.llvmContext, "check_ok", F);
+  llvm::BasicBlock* failBB = llvm::BasicBlock::Create(*drv.llvmContext, "check_fail", F);
+  drv.llvmIRBuilder->CreateCondBr(ok, okBB, failBB);
+
+  drv.llvmIRBuilder->SetInsertPoint(failBB);
+  drv.llvmIRBuilder->CreateCall(llvm::Intrinsic::getDeclaration(drv.llvmModule.get(), llvm::Intrinsic::trap));
+  drv.llvmIRBuilder->CreateUnreachable();
+
+  drv.llvmIRBuilder->SetInsertPoint(okBB);
+}
+
+// Arrays up to this many bytes live in the stack frame; larger ones are allocated with calloc.
+static const uint64_t MAX_STACK_ARRAY_BYTES = 64 * 1024;
+
+static const ArrayInfo& getArray(driver& drv, const location& loc, const std::string& name) {
+  auto it = drv.namedArrays.find(name);
+  if (it == drv.namedArrays.end())
+    error(loc, "Unknown array name: " + name);
+  return it->second;
+}
+
+// Create the zeroed array name of size elements.  Return the memory to free once it
+// goes out of scope, or nullptr if it is on the stack.
+static llvm::Value* createArray(driver& drv, llvm::Function* F, const std::string& name, uint64_t size, const location& loc) {
+  if (drv.namedPointers[name] || drv.namedArrays.count(name))
+    error(loc, "Redefinition of variable " + name);
+
+  llvm::Type* doubleTy = llvm::Type::getDoubleTy(*drv.llvmContext);
+  llvm::Type* sizeTy = llvm::Type::getInt64Ty(*drv.llvmContext);
+  llvm::Value* data;
+  llvm::Value* heap = nullptr;
+
+  if (size <= MAX_STACK_ARRAY_BYTES / sizeof(double)) {
+    // A fixed alloca in the entry block, aligned for vector loads and stores, and
+    // cleared each time the declaration is reached.
+    llvm::ArrayType* arrayTy = llvm::ArrayType::get(doubleTy, size);
+    llvm::BasicBlock& entryBlock = F->getEntryBlock();
+    llvm::IRBuilder<> builder(&entryBlock, entryBlock.begin());
+    llvm::AllocaInst* ptr = builder.CreateAlloca(arrayTy, nullptr, name);
+    ptr->setAlignment(llvm::Align(32));
+    data = builder.CreateConstInBoundsGEP2_64(arrayTy, ptr, 0, 0, name + ".data");
+
+    drv.llvmIRBuilder->CreateMemSet(data, drv.llvmIRBuilder->getInt8(0), size * sizeof(double), llvm::MaybeAlign(32));
+  } else {
+    llvm::FunctionCallee calloc = drv.llvmModule->getOrInsertFunction("calloc", drv.llvmIRBuilder->getInt8PtrTy(), sizeTy, sizeTy);
+    heap = drv.llvmIRBuilder->CreateCall(calloc, { drv.llvmIRBuilder->getInt64(size), drv.llvmIRBuilder->getInt64(sizeof(double)) }, name + ".heap");
+    createCheck(drv, drv.llvmIRBuilder->CreateIsNotNull(heap));
+    data = drv.llvmIRBuilder->CreateBitCast(heap, doubleTy->getPointerTo(), name + ".data");
+  }
+
+  drv.namedArrays[name] = ArrayInfo{ data, drv.llvmIRBuilder->getInt64(size), size };
+  return heap;
+}
+
+static void freeArray(driver& drv, llvm::Value* heap) {
+  llvm::FunctionCallee free = drv.llvmModule->getOrInsertFunction("free", drv.llvmIRBuilder->getVoidTy(), drv.llvmIRBuilder->getInt8PtrTy());
+  drv.llvmIRBuilder->CreateCall(free, { heap });
+}
+
+// A pointer to the element of array name at index.  Indexing with the induction
+// variable of a counted loop uses its integer directly, and needs no check when the
+// loop bound proves it in range; any other index is checked against the length.
+static llvm::Value* codegenElement(driver& drv, int depth, const std::string& name, ExprAST& index, const location& loc) {
+  ArrayInfo array = getArray(drv, loc, name);
+  llvm::Type* doubleTy = llvm::Type::getDoubleTy(*drv.llvmContext);
+  llvm::Value* idx = nullptr;
+
+  if (VariableExprAST* var = dynamic_cast<VariableExprAST*>(&index)) {
+    for (auto loop = drv.countedLoops.rbegin(); loop != drv.countedLoops.rend(); ++loop) {
+      if (loop->var != var->getName())
+        continue;
+
+      idx = drv.llvmIRBuilder->CreateLoad(loop->index->getAllocatedType(), loop->index, var->getName() + ".idx");
+      bool inBounds = loop->array == name || (loop->array.empty() && loop->bound <= array.static_length);
+      if (!inBounds)
+        createCheck(drv, drv.llvmIRBuilder->CreateICmpULT(idx, array.length));
+      break;
+    }
+  }
+
+  if (!idx) {
+    llvm::Value* value = index.codegen(drv, depth + 1);
+    assert(value);
+
+    llvm::Value* length = drv.llvmIRBuilder->CreateSIToFP(array.length, doubleTy);
+    createCheck(drv, drv.llvmIRBuilder->CreateAnd(
+      drv.llvmIRBuilder->CreateFCmpOGE(value, llvm::ConstantFP::get(doubleTy, 0.0)),
+      drv.llvmIRBuilder->CreateFCmpOLT(value, length)
+    ));
+    idx = drv.llvmIRBuilder->CreateFPToSI(value, drv.llvmIRBuilder->getInt64Ty(), "idx");
+  }
+
+  return drv.llvmIRBuilder->CreateInBoundsGEP(doubleTy, array.data, idx, name + ".elt");
+}
+
 static llvm::Value* doubleToBoolean(const driver& drv, llvm::Value* cond_val) {
   return drv.llvmIRBuilder->CreateFCmpONE(
     cond_val,
@@ -184,6 +464,42 @@ static llvm::Value* doubleToBoolean(const driver& drv, llvm::Value* cond_val) {
   );
 }
 
+// Build the self-referential llvm.loop node for the given pragmas, or nullptr if there are none.
+static llvm::MDNode* createLoopMetadata(const driver& drv, const LoopPragmas& pragmas) {
+  if (pragmas.empty())
+    return nullptr;
+
+  llvm::LLVMContext& ctx = *drv.llvmContext;
+  auto flag = [&](const char* name) {
+    return llvm::MDNode::get(ctx, llvm::MDString::get(ctx, name));
+  };
+  auto value = [&](const char* name, llvm::Constant* v) {
+    return llvm::MDNode::get(ctx, { llvm::MDString::get(ctx, name), llvm::ConstantAsMetadata::get(v) });
+  };
+
+  // The first operand is a placeholder for the node itself.
+  llvm::SmallVector<llvm::Metadata*, 4> ops = { nullptr };
+
+  if (pragmas.unroll_disable)
+    ops.push_back(flag("llvm.loop.unroll.disable"));
+  else if (pragmas.unroll_count > 0)
+    ops.push_back(value("llvm.loop.unroll.count", llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), pragmas.unroll_count)));
+  else if (pragmas.unroll)
+    ops.push_back(flag("llvm.loop.unroll.enable"));
+
+  if (pragmas.vectorize_disable) {
+    ops.push_back(value("llvm.loop.vectorize.enable", llvm::ConstantInt::getFalse(ctx)));
+  } else if (pragmas.vectorize) {
+    ops.push_back(value("llvm.loop.vectorize.enable", llvm::ConstantInt::getTrue(ctx)));
+    if (pragmas.vectorize_width > 0)
+      ops.push_back(value("llvm.loop.vectorize.width", llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), pragmas.vectorize_width)));
+  }
+
+  llvm::MDNode* loopID = llvm::MDNode::getDistinct(ctx, ops);
+  loopID->replaceOperandWith(0, loopID);
+  return loopID;
+}
+
 static llvm::Value* booleanToDouble(const driver& drv, llvm::Value* cond_val) {
   return drv.llvmIRBuilder->CreateUIToFP(
     cond_val,
@@ -207,27 +523,120 @@ llvm::Value* NumberExprAST::codegen(driver& drv, int depth) {
   return llvm::ConstantFP::get(*drv.llvmContext, llvm::APFloat(this->value));
 }
 
-llvm::Value* BinaryExprAST::codegen(driver& drv, int depth) {
-  static const std::map<BinaryOperator, std::string> BINOP_NAMES = {
-    { BinaryOperator::Add, "Add" },
-    { BinaryOperator::Sub, "Sub" },
-    { BinaryOperator::Mul, "Mul" },
-    { BinaryOperator::Div, "Div" },
-    { BinaryOperator::Gt, "Gt" },
-    { BinaryOperator::Gte, "Gte" },
-    { BinaryOperator::Lt, "Lt" },
-    { BinaryOperator::Lte, "Lte" },
-    { BinaryOperator::Eq, "Eq" },
-    { BinaryOperator::Neq, "Neq" },
-  };
+static const std::map<BinaryOperator, std::string> BINOP_NAMES = {
+  { BinaryOperator::Add, "Add" },
+  { BinaryOperator::Sub, "Sub" },
+  { BinaryOperator::Mul, "Mul" },
+  { BinaryOperator::Div, "Div" },
+  { BinaryOperator::Gt, "Gt" },
+  { BinaryOperator::Gte, "Gte" },
+  { BinaryOperator::Lt, "Lt" },
+  { BinaryOperator::Lte, "Lte" },
+  { BinaryOperator::Eq, "Eq" },
+  { BinaryOperator::Neq, "Neq" },
+  { BinaryOperator::And, "And" },
+  { BinaryOperator::Or, "Or" },
+};
+
+static const std::map<UnaryOperator, std::string> UNOP_NAMES = {
+  { UnaryOperator::NumericNeg, "NumericNeg" },
+  { UnaryOperator::LogicalNot, "LogicalNot" },
+};
+
+static bool isComparison(BinaryOperator op) {
+  switch (op) {
+    case BinaryOperator::Gt:
+    case BinaryOperator::Lt:
+    case BinaryOperator::Gte:
+    case BinaryOperator::Lte:
+    case BinaryOperator::Eq:
+    case BinaryOperator::Neq:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static llvm::Value* createComparison(const driver& drv, BinaryOperator op, llvm::Value* lhs, llvm::Value* rhs) {
+  switch (op) {
+    case BinaryOperator::Gt:
+      return drv.llvmIRBuilder->CreateFCmpOGT(lhs, rhs, "gt_tmp");
+    case BinaryOperator::Lt:
+      return drv.llvmIRBuilder->CreateFCmpOLT(lhs, rhs, "lt_tmp");
+    case BinaryOperator::Gte:
+      return drv.llvmIRBuilder->CreateFCmpOGE(lhs, rhs, "gte_tmp");
+    case BinaryOperator::Lte:
+      return drv.llvmIRBuilder->CreateFCmpOLE(lhs, rhs, "lte_tmp");
+    case BinaryOperator::Eq:
+      return drv.llvmIRBuilder->CreateFCmpOEQ(lhs, rhs, "eq_tmp");
+    case BinaryOperator::Neq:
+      return drv.llvmIRBuilder->CreateFCmpONE(lhs, rhs, "neq_tmp");
+    default:
+      assert(false);
+      return nullptr;
+  }
+}
+
+// The rhs of "and" / "or" is only evaluated when the lhs does not decide the result.
+static void codegenShortCircuit(driver& drv, int depth, BinaryOperator op, ExprAST& lhs, ExprAST& rhs, llvm::BasicBlock* trueBB, llvm::BasicBlock* falseBB) {
+  llvm::Function* F = drv.llvmIRBuilder->GetInsertBlock()->getParent();
+
+  if (op == BinaryOperator::And) {
+    llvm::BasicBlock* rhsBB = llvm::BasicBlock::Create(*drv.llvmContext, "and_rhs", F);
+    lhs.codegenCond(drv, depth + 1, rhsBB, falseBB);
+    drv.llvmIRBuilder->SetInsertPoint(rhsBB);
+  } else {
+    llvm::BasicBlock* rhsBB = llvm::BasicBlock::Create(*drv.llvmContext, "or_rhs", F);
+    lhs.codegenCond(drv, depth + 1, trueBB, rhsBB);
+    drv.llvmIRBuilder->SetInsertPoint(rhsBB);
+  }
 
+  rhs.codegenCond(drv, depth + 1, trueBB, falseBB);
+}
+
+void ExprAST::codegenCond(driver& drv, int depth, llvm::BasicBlock* trueBB, llvm::BasicBlock* falseBB) {
+  llvm::Value* cond_val = this->codegen(drv, depth);
+  assert(cond_val);
+
+  drv.llvmIRBuilder->CreateCondBr(doubleToBoolean(drv, cond_val), trueBB, falseBB);
+}
+
+llvm::Value* BinaryExprAST::codegen(driver& drv, int depth) {
   dbglog(drv, "Binary expression", BINOP_NAMES.at(this->op), depth, this->getLocation());
 
+  if (this->op == BinaryOperator::And || this->op == BinaryOperator::Or) {
+    // Materialize the outcome of the branches as 1.0 or 0.0.
+    llvm::Function* F = drv.llvmIRBuilder->GetInsertBlock()->getParent();
+    llvm::BasicBlock* trueBB = llvm::BasicBlock::Create(*drv.llvmContext, "logic_true");
+    llvm::BasicBlock* falseBB = llvm::BasicBlock::Create(*drv.llvmContext, "logic_false");
+    llvm::BasicBlock* mergeBB = llvm::BasicBlock::Create(*drv.llvmContext, "logic_exit");
+
+    codegenShortCircuit(drv, depth, this->op, *this->lhs, *this->rhs, trueBB, falseBB);
+
+    trueBB->insertInto(F);
+    falseBB->insertInto(F);
+    mergeBB->insertInto(F);
+
+    drv.llvmIRBuilder->SetInsertPoint(trueBB);
+    drv.llvmIRBuilder->CreateBr(mergeBB);
+    drv.llvmIRBuilder->SetInsertPoint(falseBB);
+    drv.llvmIRBuilder->CreateBr(mergeBB);
+
+    drv.llvmIRBuilder->SetInsertPoint(mergeBB);
+    llvm::PHINode *PN = drv.llvmIRBuilder->CreatePHI(llvm::Type::getDoubleTy(*drv.llvmContext), 2, "logic_tmp");
+    PN->addIncoming(llvm::ConstantFP::get(*drv.llvmContext, llvm::APFloat(1.0)), trueBB);
+    PN->addIncoming(llvm::ConstantFP::get(*drv.llvmContext, llvm::APFloat(0.0)), falseBB);
+    return PN;
+  }
+
   llvm::Value* lhs = this->lhs->codegen(drv, depth + 1);
   llvm::Value* rhs = this->rhs->codegen(drv, depth + 1);
 
   assert(lhs && rhs);
 
+  if (isComparison(this->op))
+    return booleanToDouble(drv, createComparison(drv, this->op, lhs, rhs));
+
   switch (this->op) {
     case BinaryOperator::Add:
       return drv.llvmIRBuilder->CreateFAdd(lhs, rhs, "add_tmp");
@@ -237,28 +646,37 @@ llvm::Value* BinaryExprAST::codegen(driver& drv, int depth) {
       return drv.llvmIRBuilder->CreateFMul(lhs, rhs, "mul_tmp");
     case BinaryOperator::Div:
       return drv.llvmIRBuilder->CreateFDiv(lhs, rhs, "div_tmp");
-    case BinaryOperator::Gt:
-      return booleanToDouble(drv, drv.llvmIRBuilder->CreateFCmpOGT(lhs, rhs, "gt_tmp"));
-    case BinaryOperator::Lt:
-      return booleanToDouble(drv, drv.llvmIRBuilder->CreateFCmpOLT(lhs, rhs, "lt_tmp"));
-    case BinaryOperator::Gte:
-      return booleanToDouble(drv, drv.llvmIRBuilder->CreateFCmpOGE(lhs, rhs, "gte_tmp"));
-    case BinaryOperator::Lte:
-      return booleanToDouble(drv, drv.llvmIRBuilder->CreateFCmpOLE(lhs, rhs, "lte_tmp"));
-    case BinaryOperator::Eq:
-      return booleanToDouble(drv, drv.llvmIRBuilder->CreateFCmpOEQ(lhs, rhs, "eq_tmp"));
-    case BinaryOperator::Neq:
-      return booleanToDouble(drv, drv.llvmIRBuilder->CreateFCmpONE(lhs, rhs, "neq_tmp"));
+    default:
+      break;
   }
 
   assert(false);
 }
 
-llvm::Value* UnaryExprAST::codegen(driver& drv, int depth) {
-  static const std::map<UnaryOperator, std::string> UNOP_NAMES = {
-    { UnaryOperator::NumericNeg, "NumericNeg" }
-  };
+void BinaryExprAST::codegenCond(driver& drv, int depth, llvm::BasicBlock* trueBB, llvm::BasicBlock* falseBB) {
+  if (this->op == BinaryOperator::And || this->op == BinaryOperator::Or) {
+    dbglog(drv, "Binary condition", BINOP_NAMES.at(this->op), depth, this->getLocation());
+    codegenShortCircuit(drv, depth, this->op, *this->lhs, *this->rhs, trueBB, falseBB);
+    return;
+  }
+
+  if (!isComparison(this->op)) {
+    ExprAST::codegenCond(drv, depth, trueBB, falseBB);
+    return;
+  }
+
+  // Branch on the comparison directly, without going through a double.
+  dbglog(drv, "Binary condition", BINOP_NAMES.at(this->op), depth, this->getLocation());
+
+  llvm::Value* lhs = this->lhs->codegen(drv, depth + 1);
+  llvm::Value* rhs = this->rhs->codegen(drv, depth + 1);
 
+  assert(lhs && rhs);
+
+  drv.llvmIRBuilder->CreateCondBr(createComparison(drv, this->op, lhs, rhs), trueBB, falseBB);
+}
+
+llvm::Value* UnaryExprAST::codegen(driver& drv, int depth) {
   dbglog(drv, "Unary expression", UNOP_NAMES.at(this->op), depth, this->getLocation());
 
   llvm::Value* op_value = this->operand->codegen(drv, depth + 1);
@@ -268,39 +686,130 @@ llvm::Value* UnaryExprAST::codegen(driver& drv, int depth) {
   switch (this->op) {
     case UnaryOperator::NumericNeg:
       return drv.llvmIRBuilder->CreateFNeg(op_value, "num_neg_tmp");
+    case UnaryOperator::LogicalNot:
+      // Unordered, so that "not" of a NaN holds just like NaN is false as a condition.
+      return booleanToDouble(drv, drv.llvmIRBuilder->CreateFCmpUEQ(
+        op_value,
+        llvm::ConstantFP::get(*drv.llvmContext, llvm::APFloat(0.0)),
+        "not_tmp"
+      ));
   }
 
   assert(false);
 }
 
+void UnaryExprAST::codegenCond(driver& drv, int depth, llvm::BasicBlock* trueBB, llvm::BasicBlock* falseBB) {
+  if (this->op != UnaryOperator::LogicalNot) {
+    ExprAST::codegenCond(drv, depth, trueBB, falseBB);
+    return;
+  }
+
+  dbglog(drv, "Unary condition", UNOP_NAMES.at(this->op), depth, this->getLocation());
+  this->operand->codegenCond(drv, depth + 1, falseBB, trueBB);
+}
+
+// With -runtime, putchard appends to the output buffer of the runtime inline, and only
+// calls it when the buffer is full or stdout is line buffered.
+static llvm::Value* codegenPutchard(driver& drv, llvm::Function* putchard, llvm::Value* c) {
+  llvm::LLVMContext& ctx = *drv.llvmContext;
+  llvm::IRBuilder<>& builder = *drv.llvmIRBuilder;
+
+  // struct kalrt_buffer
+  llvm::Type* sizeTy = builder.getInt64Ty();
+  llvm::StructType* bufferTy = llvm::StructType::get(ctx, { sizeTy, sizeTy, llvm::ArrayType::get(builder.getInt8Ty(), KALRT_BUFFER_SIZE) });
+  llvm::Constant* buffer = drv.llvmModule->getOrInsertGlobal("kalrt_out", bufferTy);
+
+  llvm::Function* F = builder.GetInsertBlock()->getParent();
+  llvm::BasicBlock* appendBB = llvm::BasicBlock::Create(ctx, "append", F);
+  llvm::BasicBlock* callBB = llvm::BasicBlock::Create(ctx, "putchard", F);
+  llvm::BasicBlock* mergeBB = llvm::BasicBlock::Create(ctx, "putchard_exit", F);
+
+  llvm::Value* lengthPtr = builder.CreateStructGEP(bufferTy, buffer, 0);
+  llvm::Value* length = builder.CreateLoad(sizeTy, lengthPtr, "length");
+  llvm::Value* limit = builder.CreateLoad(sizeTy, builder.CreateStructGEP(bufferTy, buffer, 1), "limit");
+  builder.CreateCondBr(builder.CreateICmpULT(length, limit), appendBB, callBB, llvm::MDBuilder(ctx).createBranchWeights(1000, 1));
+
+  builder.SetInsertPoint(appendBB);
+  llvm::Value* ptr = builder.CreateInBoundsGEP(bufferTy, buffer, { builder.getInt64(0), builder.getInt32(2), length });
+  builder.CreateStore(builder.CreateTrunc(builder.CreateFPToSI(c, builder.getInt32Ty()), builder.getInt8Ty()), ptr);
+  builder.CreateStore(builder.CreateNUWAdd(length, builder.getInt64(1)), lengthPtr);
+  builder.CreateBr(mergeBB);
+
+  builder.SetInsertPoint(callBB);
+  builder.CreateCall(putchard, { c });
+  builder.CreateBr(mergeBB);
+
+  builder.SetInsertPoint(mergeBB);
+  return llvm::ConstantFP::get(ctx, llvm::APFloat(0.0));
+}
+
 llvm::Value* CallExprAST::codegen(driver& drv, int depth) {
   dbglog(drv, "Function call", this->callee, depth, this->getLocation());
 
-  llvm::Function* fun = drv.llvmModule->getFunction(this->callee);
+  llvm::Function* fun = drv.getFunction(this->callee);
   if (!fun)
     error(this->getLocation(), "Called unknown function " + this->callee);
   
-  if (fun->arg_size() != this->args.size())
-    error(this->getLocation(), "Function call argument count mismatch: expecting " + std::to_string(fun->arg_size()) + ", got " + std::to_string(this->args.size()));
+  // An array is passed as two parameters: its data and its length.
+  size_t arity = 0;
+  for (auto& param : fun->args())
+    if (!param.getType()->isIntegerTy())
+      ++arity;
+
+  if (arity != this->args.size())
+    error(this->getLocation(), "Function call argument count mismatch: expecting " + std::to_string(arity) + ", got " + std::to_string(this->args.size()));
+
+  // With constant arguments, try running the call now and use its result instead.
+  if (drv.const_evaluator) {
+    std::vector<double> values;
+    for (auto& arg : this->args)
+      if (NumberExprAST* number = dynamic_cast<NumberExprAST*>(arg.get()))
+        values.push_back(number->getValue());
+
+    double result;
+    if (values.size() == this->args.size() && drv.const_evaluator->evaluate(this->callee, values, result)) {
+      dbglog(drv, "Constant call", this->callee + " = " + std::to_string(result), depth + 1, this->getLocation());
+      return llvm::ConstantFP::get(*drv.llvmContext, llvm::APFloat(result));
+    }
+  }
   
   std::vector<llvm::Value *> args;
+  std::vector<std::string> arrays;
   for (unsigned i = 0, e = this->args.size(); i != e; ++i) {
+    if (fun->getArg(args.size())->getType()->isPointerTy()) {
+      VariableExprAST* var = dynamic_cast<VariableExprAST*>(this->args[i].get());
+      if (!var)
+        error(this->args[i]->getLocation(), "Argument " + std::to_string(i + 1) + " of " + this->callee + " must be an array");
+
+      // Array parameters are noalias: the callee may assume they do not overlap.
+      if (std::find(arrays.begin(), arrays.end(), var->getName()) != arrays.end())
+        error(this->args[i]->getLocation(), "Array " + var->getName() + " passed twice to " + this->callee);
+      arrays.push_back(var->getName());
+
+      const ArrayInfo& array = getArray(drv, var->getLocation(), var->getName());
+      args.push_back(array.data);
+      args.push_back(array.length);
+      continue;
+    }
+
     args.push_back(this->args[i]->codegen(drv, depth + 1));
     if (!args.back())
       return nullptr;
   }
 
+  if (drv.runtime_io && this->callee == "putchard" && args.size() == 1)
+    return codegenPutchard(drv, fun, args[0]);
+
+  // With -tiered, calls go through the callee's slot so that it can be switched to optimized code.
+  if (drv.tiered)
+    return drv.llvmIRBuilder->CreateCall(fun->getFunctionType(), drv.tiered->loadCallee(drv, fun), args, "call_tmp");
+
   return drv.llvmIRBuilder->CreateCall(fun, args, "call_tmp");
 }
 
 llvm::Value* IfExprAST::codegen(driver& drv, int depth) {
   dbglog(drv, "If expression", "", depth, this->getLocation());
 
-  // Condition
-  llvm::Value* cond_val = this->cond_expr->codegen(drv, depth + 1);
-  assert(cond_val);
-  cond_val = doubleToBoolean(drv, cond_val);
-
   // CFG
   llvm::Function *F = drv.llvmIRBuilder->GetInsertBlock()->getParent();
   llvm::BasicBlock *thenBB = llvm::BasicBlock::Create(*drv.llvmContext, "then");
@@ -308,8 +817,8 @@ llvm::Value* IfExprAST::codegen(driver& drv, int depth) {
   llvm::BasicBlock *mergeBB = llvm::BasicBlock::Create(*drv.llvmContext, "ifexit");
   auto& bblist = F->getBasicBlockList();
 
-  // Conditional branch
-  drv.llvmIRBuilder->CreateCondBr(cond_val, thenBB, elseBB);
+  // Condition
+  this->cond_expr->codegenCond(drv, depth + 1, thenBB, elseBB);
   
   // Then
   bblist.insert(bblist.end(), thenBB);
@@ -357,9 +866,107 @@ llvm::Value* CompositeExprAST::codegen(driver& drv, int depth) {
   }
 }
 
+// Whether expr is a number holding a non-negative integer, returned in value.
+static bool isIndexConstant(ExprAST* expr, uint64_t& value) {
+  NumberExprAST* number = dynamic_cast<NumberExprAST*>(expr);
+  if (!number || !(number->getValue() >= 0 && number->getValue() <= (1ULL << 53)) || number->getValue() != std::floor(number->getValue()))
+    return false;
+
+  value = (uint64_t) number->getValue();
+  return true;
+}
+
+// Lower "for i = a, i < b, c in body end", with integer constants a >= 0 and c > 0, a
+// bound b that is an integer constant or len(array), and a body that never assigns i,
+// with an i64 induction variable.  The loop vectorizer needs one to compute the trip
+// count, and indexing with i then needs no conversion or, often, no bounds check.
+// Return nullptr if the loop does not have that shape.
+static llvm::Value* codegenCountedLoop(driver& drv, int depth, AssignmentExprAST& init_expr, ExprAST& cond_expr, AssignmentExprAST& step_expr, ExprAST& body_expr, const LoopPragmas& pragmas, const location& loc) {
+  const std::string& var = init_expr.getDestinationName();
+
+  uint64_t start, step, bound = 0;
+  std::string array;
+  if (!isIndexConstant(init_expr.getValue(), start))
+    return nullptr;
+
+  // The parser builds the step as "i = i + c".
+  BinaryExprAST* increment = dynamic_cast<BinaryExprAST*>(step_expr.getValue());
+  if (!increment || !isIndexConstant(increment->getRHS(), step) || step == 0)
+    return nullptr;
+
+  BinaryExprAST* cond = dynamic_cast<BinaryExprAST*>(&cond_expr);
+  VariableExprAST* lhs = cond ? dynamic_cast<VariableExprAST*>(cond->getLHS()) : nullptr;
+  if (!cond || cond->getOp() != BinaryOperator::Lt || !lhs || lhs->getName() != var)
+    return nullptr;
+
+  if (ArrayLengthExprAST* length = dynamic_cast<ArrayLengthExprAST*>(cond->getRHS()))
+    array = length->getName();
+  else if (!isIndexConstant(cond->getRHS(), bound))
+    return nullptr;
+
+  if (body_expr.assigns(var))
+    return nullptr;
+
+  dbglog(drv, "Counted loop", var, depth, loc);
+
+  llvm::Function* F = drv.llvmIRBuilder->GetInsertBlock()->getParent();
+  llvm::BasicBlock* header = llvm::BasicBlock::Create(*drv.llvmContext, "header", F);
+  llvm::BasicBlock* body = llvm::BasicBlock::Create(*drv.llvmContext, "body", F);
+  llvm::BasicBlock* exitBlock = llvm::BasicBlock::Create(*drv.llvmContext, "exitBlock", F);
+
+  llvm::Type* doubleTy = llvm::Type::getDoubleTy(*drv.llvmContext);
+  llvm::Type* indexTy = llvm::Type::getInt64Ty(*drv.llvmContext);
+  llvm::Value* limit = array.empty() ? drv.llvmIRBuilder->getInt64(bound) : getArray(drv, cond_expr.getLocation(), array).length;
+
+  llvm::AllocaInst* exitValuePtr = createAllocaInEntryBlock(drv, F, "exitValuePtr");
+  llvm::AllocaInst* varPtr = createVar(drv, F, var, loc);
+
+  llvm::BasicBlock& entryBlock = F->getEntryBlock();
+  llvm::AllocaInst* indexPtr = llvm::IRBuilder<>(&entryBlock, entryBlock.begin()).CreateAlloca(indexTy, nullptr, var + ".idx");
+
+  /* PREHEADER */
+  drv.llvmIRBuilder->CreateStore(llvm::ConstantFP::get(doubleTy, 0.0), exitValuePtr);
+  drv.llvmIRBuilder->CreateStore(drv.llvmIRBuilder->getInt64(start), indexPtr);
+  drv.llvmIRBuilder->CreateBr(header);
+
+  /* HEADER */
+  // The double variable follows the index, so that it holds the exit value after the loop.
+  drv.llvmIRBuilder->SetInsertPoint(header);
+  llvm::Value* index = drv.llvmIRBuilder->CreateLoad(indexTy, indexPtr, var + ".idx");
+  drv.llvmIRBuilder->CreateStore(drv.llvmIRBuilder->CreateSIToFP(index, doubleTy), varPtr);
+  drv.llvmIRBuilder->CreateCondBr(drv.llvmIRBuilder->CreateICmpSLT(index, limit, "cond"), body, exitBlock);
+
+  /* BODY */
+  drv.llvmIRBuilder->SetInsertPoint(body);
+
+  drv.countedLoops.push_back(CountedLoop{ var, indexPtr, array, bound });
+  llvm::Value* body_val = body_expr.codegen(drv, depth + 1);
+  assert(body_val);
+  drv.countedLoops.pop_back();
+
+  drv.llvmIRBuilder->CreateStore(body_val, exitValuePtr);
+
+  index = drv.llvmIRBuilder->CreateLoad(indexTy, indexPtr, var + ".idx");
+  drv.llvmIRBuilder->CreateStore(drv.llvmIRBuilder->CreateNSWAdd(index, drv.llvmIRBuilder->getInt64(step)), indexPtr);
+
+  if (drv.tiered)
+    drv.tiered->countLoop(drv, F, loc, exitBlock);
+
+  llvm::BranchInst* latch = drv.llvmIRBuilder->CreateBr(header);
+  if (llvm::MDNode* loopID = createLoopMetadata(drv, pragmas))
+    latch->setMetadata(llvm::LLVMContext::MD_loop, loopID);
+
+  /* EXIT BLOCK */
+  drv.llvmIRBuilder->SetInsertPoint(exitBlock);
+  return drv.llvmIRBuilder->CreateLoad(exitValuePtr->getAllocatedType(), exitValuePtr);
+}
+
 llvm::Value* ForExprAST::codegen(driver& drv, int depth)  {
   dbglog(drv, "For Expression", "", depth, this->getLocation());
 
+  if (llvm::Value* value = codegenCountedLoop(drv, depth + 1, *this->init_expr, *this->cond_expr, *this->step_expr, *this->body_expr, this->pragmas, this->getLocation()))
+    return value;
+
   // CFG
   llvm::Function* F = drv.llvmIRBuilder->GetInsertBlock()->getParent();
   llvm::BasicBlock* header = llvm::BasicBlock::Create(*drv.llvmContext, "header", F);
@@ -388,14 +995,7 @@ llvm::Value* ForExprAST::codegen(driver& drv, int depth)  {
   /* HEADER */
   drv.llvmIRBuilder->SetInsertPoint(header);
 
-  llvm::Value* cond_val = this->cond_expr->codegen(drv, depth + 1);
-  assert(cond_val);
-
-  drv.llvmIRBuilder->CreateCondBr(
-    doubleToBoolean(drv, cond_val), 
-    body, 
-    exitBlock
-  );
+  this->cond_expr->codegenCond(drv, depth + 1, body, exitBlock);
   
 
   /* BODY */
@@ -410,7 +1010,12 @@ llvm::Value* ForExprAST::codegen(driver& drv, int depth)  {
   // Increment the induction variable.
   this->step_expr->codegen(drv, depth + 1);
 
-  drv.llvmIRBuilder->CreateBr(header);
+  if (drv.tiered)
+    drv.tiered->countLoop(drv, F, this->getLocation(), exitBlock);
+
+  llvm::BranchInst* latch = drv.llvmIRBuilder->CreateBr(header);
+  if (llvm::MDNode* loopID = createLoopMetadata(drv, this->pragmas))
+    latch->setMetadata(llvm::LLVMContext::MD_loop, loopID);
 
 
   /* EXIT BLOCK */
@@ -444,11 +1049,7 @@ llvm::Value* WhileExprAST::codegen(driver& drv, int depth)  {
   // Header
   drv.llvmIRBuilder->SetInsertPoint(header);
 
-  llvm::Value* cond_val = this->cond_expr->codegen(drv, depth + 1);
-  assert(cond_val);
-  cond_val = doubleToBoolean(drv, cond_val);
-
-  drv.llvmIRBuilder->CreateCondBr(cond_val, body, exitBlock);
+  this->cond_expr->codegenCond(drv, depth + 1, body, exitBlock);
   
 
   // Body
@@ -458,7 +1059,13 @@ llvm::Value* WhileExprAST::codegen(driver& drv, int depth)  {
   assert(body_val);
 
   drv.llvmIRBuilder->CreateStore(body_val, exitValuePtr);
-  drv.llvmIRBuilder->CreateBr(header);
+
+  if (drv.tiered)
+    drv.tiered->countLoop(drv, F, this->getLocation(), exitBlock);
+
+  llvm::BranchInst* latch = drv.llvmIRBuilder->CreateBr(header);
+  if (llvm::MDNode* loopID = createLoopMetadata(drv, this->pragmas))
+    latch->setMetadata(llvm::LLVMContext::MD_loop, loopID);
 
 
   // Exit block
@@ -478,6 +1085,8 @@ llvm::Value* AssignmentExprAST::codegen(driver& drv, int depth) {
 }
 
 llvm::Value* VarExprAST::codegen(driver& drv, int depth) {
+  std::vector<llvm::Value*> heapArrays;
+
   if (this->declarations.size() > 0) {
 
     std::string varnames = this->declarations[0].first;
@@ -488,6 +1097,12 @@ llvm::Value* VarExprAST::codegen(driver& drv, int depth) {
     llvm::Function* F = drv.llvmIRBuilder->GetInsertBlock()->getParent();
 
     for (auto &decl : this->declarations) {
+      if (NewArrayExprAST* array = dynamic_cast<NewArrayExprAST*>(decl.second.get())) {
+        dbglog(drv, "New array", decl.first + "[" + std::to_string(array->getSize()) + "]", depth + 1, array->getLocation());
+        heapArrays.push_back(createArray(drv, F, decl.first, array->getSize(), this->getLocation()));
+        continue;
+      }
+
       llvm::Value* initValue = decl.second->codegen(drv, depth + 1);
       assert(initValue);
 
@@ -497,7 +1112,49 @@ llvm::Value* VarExprAST::codegen(driver& drv, int depth) {
     dbglog(drv, "VarExpr", "", depth, this->getLocation());
   }
 
-  return this->body->codegen(drv, depth + 1);
+  llvm::Value* value = this->body->codegen(drv, depth + 1);
+
+  // Unlike numbers, arrays go out of scope with the body.
+  for (auto &decl : this->declarations)
+    if (dynamic_cast<NewArrayExprAST*>(decl.second.get()))
+      drv.namedArrays.erase(decl.first);
+  for (llvm::Value* heap : heapArrays)
+    if (heap)
+      freeArray(drv, heap);
+
+  return value;
+}
+
+llvm::Value* NewArrayExprAST::codegen(driver& drv, int depth) {
+  error(this->getLocation(), "Arrays can only be created by var declarations");
+  return nullptr;
+}
+
+llvm::Value* ArrayIndexExprAST::codegen(driver& drv, int depth) {
+  dbglog(drv, "Array index", this->name, depth, this->getLocation());
+
+  llvm::Value* ptr = codegenElement(drv, depth, this->name, *this->index_expr, this->getLocation());
+  llvm::LoadInst* load = drv.llvmIRBuilder->CreateLoad(llvm::Type::getDoubleTy(*drv.llvmContext), ptr, this->name);
+  load->setAlignment(llvm::Align(8));
+  return load;
+}
+
+llvm::Value* ArrayAssignExprAST::codegen(driver& drv, int depth) {
+  dbglog(drv, "Array assignment", this->name, depth, this->getLocation());
+
+  llvm::Value* ptr = codegenElement(drv, depth, this->name, *this->index_expr, this->getLocation());
+  llvm::Value* value = this->value_expr->codegen(drv, depth + 1);
+  assert(value);
+
+  drv.llvmIRBuilder->CreateAlignedStore(value, ptr, llvm::Align(8));
+  return value;
+}
+
+llvm::Value* ArrayLengthExprAST::codegen(driver& drv, int depth) {
+  dbglog(drv, "Array length", this->name, depth, this->getLocation());
+
+  const ArrayInfo& array = getArray(drv, this->getLocation(), this->name);
+  return drv.llvmIRBuilder->CreateSIToFP(array.length, llvm::Type::getDoubleTy(*drv.llvmContext), "len");
 }
 
 
@@ -505,15 +1162,36 @@ llvm::Value* VarExprAST::codegen(driver& drv, int depth) {
 llvm::Function* FunctionPrototypeAST::codegen(driver& drv, int depth) {
   dbglog(drv, "Function prototype", this->getName(), depth, this->getLocation());
 
-  std::vector<llvm::Type *> types(this->argsNames.size(), llvm::Type::getDoubleTy(*drv.llvmContext));
+  // An array parameter a becomes a pointer a to its elements and an i64 a.len.
+  llvm::Type* doubleTy = llvm::Type::getDoubleTy(*drv.llvmContext);
+  std::vector<llvm::Type *> types;
+  for (size_t i = 0; i < this->argsNames.size(); ++i) {
+    if (this->isArrayArg(i)) {
+      types.push_back(doubleTy->getPointerTo());
+      types.push_back(llvm::Type::getInt64Ty(*drv.llvmContext));
+    } else {
+      types.push_back(doubleTy);
+    }
+  }
 
-  llvm::FunctionType *FT = llvm::FunctionType::get(llvm::Type::getDoubleTy(*drv.llvmContext), types, false);
+  llvm::FunctionType *FT = llvm::FunctionType::get(doubleTy, types, false);
 
   llvm::Function *F = llvm::Function::Create(FT, llvm::Function::ExternalLinkage, this->name, drv.llvmModule.get());
 
   unsigned i = 0;
-  for (auto &arg : F->args())
-    arg.setName(this->argsNames[i++]);
+  for (auto arg = F->arg_begin(); arg != F->arg_end(); ++arg, ++i) {
+    arg->setName(this->argsNames[i]);
+    if (this->isArrayArg(i)) {
+      // Callers never pass the same array twice, and the callee cannot keep it.
+      arg->addAttr(llvm::Attribute::NoAlias);
+      arg->addAttr(llvm::Attribute::NoCapture);
+      arg->addAttr(llvm::Attribute::getWithAlignment(*drv.llvmContext, llvm::Align(8)));
+      (++arg)->setName(this->argsNames[i] + ".len");
+    }
+  }
+
+  if (drv.const_evaluator)
+    drv.const_evaluator->declare(*this);
 
   return F;
 }
@@ -521,21 +1199,37 @@ llvm::Function* FunctionPrototypeAST::codegen(driver& drv, int depth) {
 llvm::Value* FunctionAST::codegen(driver& drv, int depth) {
   dbglog(drv, "Function", this->prototype->getName(), depth, this->getLocation());
 
-  llvm::Function* F = drv.llvmModule->getFunction(this->prototype->getName());
+  llvm::Function* F = drv.getFunction(this->prototype->getName());
   if (!F)
     F = this->prototype->codegen(drv, depth + 1);
 
   assert(F);
 
-  if (!F->empty())
+  if (!F->empty() || drv.streamedFunctions.count(F->getName()))
     error(this->getLocation(), "Redefinition of function " + std::string(F->getName()));
 
+  if (drv.runtime_io && F->getName() == "putchard")
+    error(this->getLocation(), "putchard is provided by the runtime");
+
   llvm::BasicBlock* entryBB = llvm::BasicBlock::Create(*drv.llvmContext, "entry", F);
   drv.llvmIRBuilder->SetInsertPoint(entryBB);
 
   drv.namedPointers.clear();
-  for (auto &arg : F->args())
-    createVar(drv, F, std::string(arg.getName()), this->getLocation(), &arg);
+  drv.namedArrays.clear();
+  drv.countedLoops.clear();
+  for (auto arg = F->arg_begin(); arg != F->arg_end(); ++arg) {
+    if (arg->getType()->isPointerTy()) {
+      llvm::Argument* data = arg++;
+      if (drv.namedPointers[std::string(data->getName())] || drv.namedArrays.count(std::string(data->getName())))
+        error(this->getLocation(), "Redefinition of variable " + std::string(data->getName()));
+      drv.namedArrays[std::string(data->getName())] = ArrayInfo{ data, arg, 0 };
+    } else {
+      createVar(drv, F, std::string(arg->getName()), this->getLocation(), arg);
+    }
+  }
+
+  if (drv.tiered)
+    drv.tiered->countCall(drv, F, *this);
 
   llvm::Value *returnValue = this->body->codegen(drv, depth + 1);
   assert(returnValue);
@@ -543,26 +1237,34 @@ llvm::Value* FunctionAST::codegen(driver& drv, int depth) {
 
   llvm::verifyFunction(*F);
 
+  if (drv.const_evaluator)
+    drv.const_evaluator->define(*this);
+
   return F;
 }
 
+std::unique_ptr<RootAST> makeTopLevelDefinition(driver& drv, std::unique_ptr<RootAST> top) {
+  ExprAST* expr = dynamic_cast<ExprAST*>(top.get());
+  if (!expr)
+    return top;
+
+  // We have a top level expression - replace it with an anonymous function
+
+  // We need to get a new unique_ptr to ExprAST...
+  top.release();
+  std::unique_ptr<ExprAST> expr_ptr = std::unique_ptr<ExprAST>(expr);
+  const location loc = expr_ptr->getLocation();
+
+  const std::string anon_fun_name = "__anon_expr" + std::to_string(drv.get_unique_id());
+  auto anon_fun_proto = std::make_unique<FunctionPrototypeAST>(anon_fun_name, std::vector<std::string>(), loc);
+  return std::make_unique<FunctionAST>(std::move(anon_fun_proto), std::move(expr_ptr), loc);
+}
+
 llvm::Value* SequenceAST::codegen(driver& drv, int depth) {
   dbglog(drv, "Sequence", "", depth, this->getLocation());
 
   if (this->current) {
-    if (ExprAST* expr = dynamic_cast<ExprAST*>(this->current.get())) {
-      // We have a top level expression - replace it with an anonymous function
-
-      // We need to get a new unique_ptr to ExprAST...
-      this->current.release();
-      std::unique_ptr<ExprAST> expr_ptr = std::unique_ptr<ExprAST>(expr);
-      
-      // Create the anon function and replace the current node with it
-      const std::string anon_fun_name = "__anon_expr" + std::to_string(drv.get_unique_id());
-      auto anon_fun_proto = std::make_unique<FunctionPrototypeAST>(anon_fun_name, std::vector<std::string>(), expr_ptr->getLocation());
-      this->current = std::make_unique<FunctionAST>(std::move(anon_fun_proto), std::move(expr_ptr), expr_ptr->getLocation());
-    }
-
+    this->current = makeTopLevelDefinition(drv, std::move(this->current));
     this->current->codegen(drv, depth + 1);
   }
 
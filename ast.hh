@@ -5,13 +5,26 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <stdexcept>
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Function.h>
-#include "location.hh"
+#include "source.hh"
 
 class driver;
+class BytecodeCompiler;
 
-typedef yy::location location;
+typedef SourceRange location;
+
+// Raised by codegen when the program is semantically invalid.
+class codegen_error : public std::runtime_error {
+  location loc;
+
+  public:
+    codegen_error(const location& loc, const std::string& message);
+    const location& getLocation() const { return loc; }
+    // The message prefixed with its line and column.
+    std::string describe(const driver& drv) const;
+};
 
 class RootAST {
   const location loc;
@@ -20,6 +33,10 @@ class RootAST {
     RootAST(const location& loc) : loc(loc) {}
     const location& getLocation() { return loc; }
     virtual llvm::Value* codegen(driver &drv, int depth) { return nullptr; };
+    // Compile a top-level construct for the interpreter.
+    virtual void emit(BytecodeCompiler& bc) {}
+    // Append the names of the functions called in this subtree.
+    virtual void collectCallees(std::vector<std::string>& callees) {}
     virtual ~RootAST() = default;
 };
 
@@ -30,6 +47,17 @@ class RootAST {
 class ExprAST : public RootAST { 
 public:
   ExprAST(const location& loc) : RootAST(loc) {}
+
+  // Lower the expression as a condition: branch to trueBB if it is non-zero, to falseBB otherwise.
+  virtual void codegenCond(driver& drv, int depth, llvm::BasicBlock* trueBB, llvm::BasicBlock* falseBB);
+
+  // Compile the expression for the interpreter, storing its value in register dst.
+  virtual void emitValue(BytecodeCompiler& bc, int dst);
+  // Same as codegenCond: emit jumps, appended to jumps, taken when the condition equals jumpIf.
+  virtual void emitCond(BytecodeCompiler& bc, bool jumpIf, std::vector<size_t>& jumps);
+
+  // Whether evaluating the expression may assign the scalar variable name.
+  virtual bool assigns(const std::string& name) { return false; }
 };
 
 
@@ -42,6 +70,9 @@ public:
     const location& loc);
 
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+
+  const std::string &getName() const;
 };
 
 
@@ -54,13 +85,17 @@ public:
     const location& loc);
 
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+
+  double getValue() const;
 };
 
 
 enum class BinaryOperator {
   Add, Sub, Mul, Div,
   Gt, Gte, Lt, Lte,
-  Eq, Neq
+  Eq, Neq,
+  And, Or
 };
 
 class BinaryExprAST : public ExprAST {
@@ -75,11 +110,21 @@ public:
     const location& loc);
 
   llvm::Value* codegen(driver& drv, int depth) override;
+  void codegenCond(driver& drv, int depth, llvm::BasicBlock* trueBB, llvm::BasicBlock* falseBB) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void emitCond(BytecodeCompiler& bc, bool jumpIf, std::vector<size_t>& jumps) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
+
+  BinaryOperator getOp() const;
+  ExprAST* getLHS() const;
+  ExprAST* getRHS() const;
 };
 
 
 enum class UnaryOperator {
-  NumericNeg
+  NumericNeg,
+  LogicalNot
 };
 
 class UnaryExprAST : public ExprAST {
@@ -93,6 +138,11 @@ public:
     const location& loc);
   
   llvm::Value* codegen(driver& drv, int depth) override;
+  void codegenCond(driver& drv, int depth, llvm::BasicBlock* trueBB, llvm::BasicBlock* falseBB) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void emitCond(BytecodeCompiler& bc, bool jumpIf, std::vector<size_t>& jumps) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
 };
 
 
@@ -108,6 +158,9 @@ public:
     const location& loc);
     
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
 };
 
 
@@ -122,6 +175,9 @@ public:
     const location& loc);
   
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
 };
 
 
@@ -136,6 +192,9 @@ public:
     const location& loc);
   
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
 };
 
 class AssignmentExprAST : public ExprAST {
@@ -149,36 +208,62 @@ public:
     const location& loc);
 
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
 
   const std::string &getDestinationName() const;
+  ExprAST* getValue() const;
+};
+
+// Optimization hints attached to a loop with the @unroll / @vectorize pragmas.
+// A count of 0 means "not specified".
+struct LoopPragmas {
+  bool unroll = false, unroll_disable = false;
+  unsigned unroll_count = 0;
+
+  bool vectorize = false, vectorize_disable = false;
+  unsigned vectorize_width = 0;
+
+  bool empty() const { return !unroll && !unroll_disable && !vectorize && !vectorize_disable; }
 };
 
 class ForExprAST : public ExprAST {
   std::unique_ptr<AssignmentExprAST> init_expr, step_expr;
   std::unique_ptr<ExprAST> cond_expr, body_expr;
+  LoopPragmas pragmas;
 
 public:
   ForExprAST(
     std::unique_ptr<AssignmentExprAST> init_expr,
     std::unique_ptr<ExprAST> cond_expr,
     std::unique_ptr<AssignmentExprAST> step_expr,
+    LoopPragmas pragmas,
     std::unique_ptr<ExprAST> body_expr,
     const location& loc);
 
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
 };
 
 
 class WhileExprAST : public ExprAST {
   std::unique_ptr<ExprAST> cond_expr, body_expr;
+  LoopPragmas pragmas;
 
 public:
   WhileExprAST(
     std::unique_ptr<ExprAST> cond_expr,
+    LoopPragmas pragmas,
     std::unique_ptr<ExprAST> body_expr,
     const location& loc);
 
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
 };
 
 
@@ -193,6 +278,78 @@ public:
     const location& loc);
 
   llvm::Value* codegen(driver& drv, int  depth) override;
+  void emitValue(BytecodeCompiler& bc, int dst) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
+};
+
+
+/* ARRAYS */
+
+
+// Arrays of doubles: "var a[size]" declares one, zeroed, and "f(a[] n)" takes one as
+// a pointer and a length.  Arrays are not values: they can only be indexed, measured
+// with len(a) or passed on to calls.
+
+// The initializer of an array in a var declaration.
+class NewArrayExprAST : public ExprAST {
+  uint64_t size;
+
+public:
+  NewArrayExprAST(
+    uint64_t size,
+    const location& loc);
+
+  llvm::Value* codegen(driver& drv, int depth) override;
+
+  uint64_t getSize() const;
+};
+
+
+class ArrayIndexExprAST : public ExprAST {
+  std::string name;
+  std::unique_ptr<ExprAST> index_expr;
+
+public:
+  ArrayIndexExprAST(
+    const std::string &name,
+    std::unique_ptr<ExprAST> index_expr,
+    const location& loc);
+
+  llvm::Value* codegen(driver& drv, int depth) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
+};
+
+
+class ArrayAssignExprAST : public ExprAST {
+  std::string name;
+  std::unique_ptr<ExprAST> index_expr, value_expr;
+
+public:
+  ArrayAssignExprAST(
+    const std::string &name,
+    std::unique_ptr<ExprAST> index_expr,
+    std::unique_ptr<ExprAST> value_expr,
+    const location& loc);
+
+  llvm::Value* codegen(driver& drv, int depth) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+  bool assigns(const std::string& name) override;
+};
+
+
+class ArrayLengthExprAST : public ExprAST {
+  std::string name;
+
+public:
+  ArrayLengthExprAST(
+    const std::string &name,
+    const location& loc);
+
+  llvm::Value* codegen(driver& drv, int depth) override;
+
+  const std::string &getName() const;
 };
 
 
@@ -210,21 +367,32 @@ public:
     const location& loc);
   
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emit(BytecodeCompiler& bc) override;
 };
 
+// Top-level expressions are lowered as anonymous functions: wrap TOP into one if it is an expression.
+std::unique_ptr<RootAST> makeTopLevelDefinition(driver& drv, std::unique_ptr<RootAST> top);
+
 
 class FunctionPrototypeAST : public RootAST {
   std::string name;
   std::vector<std::string> argsNames;
+  // Which arguments are arrays; empty when none is.
+  std::vector<bool> arrayArgs;
 
 public:
   FunctionPrototypeAST(
     const std::string &name,
     std::vector<std::string> argsNames,
-    const location& loc);
+    const location& loc,
+    std::vector<bool> arrayArgs = std::vector<bool>());
 
   llvm::Function* codegen(driver& drv, int depth) override;
+  void emit(BytecodeCompiler& bc) override;
   const std::string &getName() const;
+  const std::vector<std::string> &getArgsNames() const;
+  bool isArrayArg(size_t i) const;
+  bool hasArrayArgs() const;
 };
 
 
@@ -239,6 +407,10 @@ public:
     const location& loc);
 
   llvm::Value* codegen(driver& drv, int depth) override;
+  void emit(BytecodeCompiler& bc) override;
+  void collectCallees(std::vector<std::string>& callees) override;
+
+  const std::string &getName() const;
 };
 
 #endif // !AST_HH
\ No newline at end of file
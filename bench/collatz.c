@@ -0,0 +1,19 @@
+#include <math.h>
+
+double steps(double x)
+{
+  double s = 0;
+  while (x > 1) {
+    x = x - 2 * floor(x / 2) == 0 ? x / 2 : 3 * x + 1;
+    s = s + 1;
+  }
+  return s;
+}
+
+double kernel(double n)
+{
+  double total = 0;
+  for (double i = 1; i < n; i = i + 1)
+    total = total + steps(i);
+  return total;
+}
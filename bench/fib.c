@@ -0,0 +1,9 @@
+double fib(double n)
+{
+  if (n < 2)
+    return n;
+  else
+    return fib(n - 1) + fib(n - 2);
+}
+
+double kernel(double n) { return fib(n); }
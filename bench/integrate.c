@@ -0,0 +1,10 @@
+/* Midpoint rule for the integral of 4 / (1 + x^2) over [0, 1], which is pi. */
+double kernel(double n)
+{
+  double h = 1 / n, sum = 0;
+  for (double i = 0; i < n; i = i + 1) {
+    double x = (i + 0.5) * h;
+    sum = sum + 4 / (1 + x * x);
+  }
+  return sum * h;
+}
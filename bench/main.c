@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Every benchmark defines its kernel, either in Kaleidoscope or in C. */
+double kernel(double n);
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Usage: bench n [repetitions]
+ * Prints the best running time in seconds and the kernel result, used as a checksum. */
+int main(int argc, char *argv[])
+{
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s n [repetitions]\n", argv[0]);
+    return 1;
+  }
+
+  double n = atof(argv[1]);
+  int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+  double best = -1, result = 0;
+  for (int i = 0; i < reps; ++i) {
+    double start = now();
+    result = kernel(n);
+    double elapsed = now() - start;
+
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+
+  printf("%.6f %.17g\n", best, result);
+  return 0;
+}
@@ -0,0 +1,20 @@
+double mandel(double cr, double ci)
+{
+  double zr = 0, zi = 0, it = 0, t = 0;
+  while ((it < 100) * (zr * zr + zi * zi < 4)) {
+    t = zr * zr - zi * zi + cr;
+    zi = 2 * zr * zi + ci;
+    zr = t;
+    it = it + 1;
+  }
+  return it;
+}
+
+double kernel(double n)
+{
+  double total = 0;
+  for (double y = 0; y < n; y = y + 1)
+    for (double x = 0; x < n; x = x + 1)
+      total = total + mandel(x * 3 / n - 2, y * 3 / n - 1.5);
+  return total;
+}
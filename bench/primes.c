@@ -0,0 +1,20 @@
+#include <math.h>
+
+double isprime(double p)
+{
+  double d = 2, prime = 1;
+  while (prime * (d * d <= p)) {
+    if (fmod(p, d) == 0)
+      prime = 0;
+    d = d + 1;
+  }
+  return prime;
+}
+
+double kernel(double n)
+{
+  double count = 0;
+  for (double p = 2; p < n; p = p + 1)
+    count = count + isprime(p);
+  return count;
+}
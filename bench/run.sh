@@ -0,0 +1,57 @@
+#!/bin/bash
+# Build every kernel both with kalcc and from its C version at the same
+# optimization level, run them and report how much slower the kalcc code is.
+#
+# Usage: bench/run.sh [kernel...]
+# Environment: KALCC (default ./kalcc), CC (default clang-14), OPT_LEVEL (default 2), REPS (default 3)
+
+set -e
+
+LLVM_VERSION=14
+
+cd "$(dirname "$0")"
+
+KALCC=${KALCC:-../kalcc}
+CC=${CC:-clang-$LLVM_VERSION}
+OPT_LEVEL=${OPT_LEVEL:-2}
+REPS=${REPS:-3}
+BUILD=build
+
+# Kernel names with the argument they are run with.
+KERNELS="fib:35 integrate:100000000 mandelbrot:1000 primes:300000 collatz:300000"
+
+if [ "$#" -gt 0 ]; then
+  SELECTED="$*"
+else
+  SELECTED=$(for k in $KERNELS; do echo -n "${k%%:*} "; done)
+fi
+
+# opt and llc optimize for the same target as the C compiler, rather than a generic one.
+TRIPLE=$($CC -dumpmachine)
+
+mkdir -p $BUILD
+
+printf "%-12s %12s %12s %8s  %s\n" "kernel" "kalcc (s)" "C (s)" "ratio" "result"
+
+for entry in $KERNELS; do
+  name=${entry%%:*}
+  n=${entry##*:}
+  case " $SELECTED " in *" $name "*) ;; *) continue ;; esac
+
+  $KALCC $name.k | opt-$LLVM_VERSION -O$OPT_LEVEL -mtriple=$TRIPLE | llc-$LLVM_VERSION -O$OPT_LEVEL -mtriple=$TRIPLE -filetype=obj -relocation-model=pic -o $BUILD/$name.kal.o
+  $CC -O$OPT_LEVEL -c $name.c -o $BUILD/$name.c.o
+
+  $CC -O$OPT_LEVEL main.c $BUILD/$name.kal.o -lm -o $BUILD/$name.kal
+  $CC -O$OPT_LEVEL main.c $BUILD/$name.c.o -lm -o $BUILD/$name.c
+
+  read kal_time kal_result <<< "$($BUILD/$name.kal $n $REPS)"
+  read c_time c_result <<< "$($BUILD/$name.c $n $REPS)"
+
+  result=$kal_result
+  if [ "$kal_result" != "$c_result" ]; then
+    result="MISMATCH: $kal_result (kalcc) vs $c_result (C)"
+  fi
+
+  ratio=$(awk "BEGIN { printf \"%.2f\", $kal_time / $c_time }")
+  printf "%-12s %12s %12s %8s  %s\n" "$name" "$kal_time" "$c_time" "$ratio" "$result"
+done
@@ -1,15 +1,72 @@
 #include "driver.hh"
 #include "parser.hh"
+#include "interp.hh"
+#include <algorithm>
+#include <mutex>
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
 
 driver::driver ()
-  : trace_parsing(false), 
-    trace_scanning(false),
+  : unique_id(0),
+    const_eval(true),
+    runtime_io(false),
+    flush_output(nullptr),
+    tiered(nullptr),
+    tier(0),
+    streaming(false),
+    only_reachable(false),
+    trace_parsing(false),
     trace_codegen(false),
-    unique_id(0)
-{ 
+    scanner(nullptr),
+    trace_scanning(false),
+    stream_out(nullptr)
+{ }
+
+driver::~driver () = default;
+
+// The data layout of the host, whose triple the modules get: opt and llc take
+// both from the module, and need them to cost and vectorize loops for it.
+static const std::string& hostDataLayout ()
+{
+  static std::once_flag once;
+  static std::string layout;
+  std::call_once(once, [] {
+    llvm::InitializeNativeTarget();
+
+    std::string triple = llvm::sys::getDefaultTargetTriple(), error;
+    if (const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple, error)) {
+      std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(triple, "generic", "", llvm::TargetOptions(), llvm::None));
+      layout = machine->createDataLayout().getStringRepresentation();
+    }
+  });
+  return layout;
+}
+
+void driver::init_codegen ()
+{
   llvmContext = std::make_unique<llvm::LLVMContext>();
   llvmModule = std::make_unique<llvm::Module>("Kaleidoscope", *llvmContext);
+  llvmModule->setTargetTriple(llvm::sys::getDefaultTargetTriple());
+  llvmModule->setDataLayout(hostDataLayout());
   llvmIRBuilder = std::make_unique<llvm::IRBuilder<>>(*llvmContext);
+
+  if (const_eval)
+    const_evaluator = std::make_unique<ConstEvaluator>(*this);
+}
+
+std::string driver::describe (const SourceRange& range) const
+{
+  SourcePosition begin = lines.resolve(range.begin), end = lines.resolve(range.end);
+  unsigned end_column = end.column > 1 ? end.column - 1 : end.column;
+
+  std::string out = file + ":" + std::to_string(begin.line) + "." + std::to_string(begin.column);
+  if (begin.line < end.line)
+    out += "-" + std::to_string(end.line) + "." + std::to_string(end_column);
+  else if (begin.column < end_column)
+    out += "-" + std::to_string(end_column);
+  return out;
 }
 
 unsigned long long driver::get_unique_id() {
@@ -19,14 +76,253 @@ unsigned long long driver::get_unique_id() {
 int driver::parse (const std::string &f)
 {
   file = f;
-  location.initialize (&file);
+  location = SourceRange();
+  lines.clear();
   
-  scan_begin();
+  if (!scan_begin())
+    return 1;
+
+  return run_parser();
+}
+
+int driver::parse_string (llvm::StringRef source, const std::string &name)
+{
+  file = name;
+  location = SourceRange();
+  lines.clear();
 
+  scan_begin_string(source);
+
+  return run_parser();
+}
+
+int driver::run_parser ()
+{
   yy::parser parser(*this);
   parser.set_debug_level (trace_parsing);
 
-  int res = parser.parse();
+  int res;
+  try {
+    res = parser.parse();
+  } catch (...) {
+    scan_end();
+    throw;
+  }
+
   scan_end();
   return res;
 }
+
+void driver::top_level (std::unique_ptr<RootAST> top, const SourceRange &loc)
+{
+  if (!streaming) {
+    pending.emplace_back(std::move(top), loc);
+    return;
+  }
+
+  if (!top)
+    return;
+
+  // Lower it right away: the AST is freed when this returns.
+  top = makeTopLevelDefinition(*this, std::move(top));
+  llvm::Function* F = llvm::dyn_cast_or_null<llvm::Function>(top->codegen(*this, 0));
+
+  if (F && !F->isDeclaration())
+    stream_function(F);
+
+  // Nothing before the end of this construct is reported any more.
+  lines.discardBefore(loc.end);
+}
+
+void driver::end_program (const SourceRange &loc)
+{
+  if (only_reachable)
+    drop_unreachable();
+
+  // Chain the top-level constructs back to front, each node spanning until the end of the input.
+  std::unique_ptr<SequenceAST> seq;
+  while (!pending.empty()) {
+    SourceRange l = pending.back().second;
+    l.end = loc.end;
+
+    seq = std::make_unique<SequenceAST>(std::move(pending.back().first), std::move(seq), l);
+    pending.pop_back();
+  }
+
+  root = std::move(seq);
+}
+
+void driver::drop_unreachable ()
+{
+  // Walk the call graph from the roots: top-level expressions and exported functions.
+  std::map<std::string, FunctionAST*> definitions;
+  std::vector<std::string> callees(exports);
+
+  for (auto& top : pending) {
+    if (FunctionAST* function = dynamic_cast<FunctionAST*>(top.first.get()))
+      definitions.emplace(function->getName(), function);
+    else if (top.first)
+      top.first->collectCallees(callees);
+  }
+
+  for (auto& name : exports)
+    if (!definitions.count(name))
+      diagnostics.push_back(file + ": exported function " + name + " is not defined");
+
+  llvm::StringSet<> reachable;
+  while (!callees.empty()) {
+    std::string name = std::move(callees.back());
+    callees.pop_back();
+
+    if (!reachable.insert(name).second)
+      continue;
+
+    auto it = definitions.find(name);
+    if (it != definitions.end())
+      it->second->collectCallees(callees);
+  }
+
+  // Prototypes are kept: they cost nothing to lower.
+  auto kept = std::remove_if(pending.begin(), pending.end(), [&](const std::pair<std::unique_ptr<RootAST>, SourceRange>& top) {
+    FunctionAST* function = dynamic_cast<FunctionAST*>(top.first.get());
+    if (!function || reachable.count(function->getName()))
+      return false;
+
+    skippedFunctions.push_back(function->getName());
+    return true;
+  });
+  pending.erase(kept, pending.end());
+}
+
+void driver::stream_begin (llvm::raw_ostream &out)
+{
+  stream_out = &out;
+  stream_module = std::make_unique<llvm::Module>(llvmModule->getModuleIdentifier(), *llvmContext);
+  stream_slots = std::make_unique<llvm::ModuleSlotTracker>(stream_module.get(), false);
+
+  out << "; ModuleID = '" << llvmModule->getModuleIdentifier() << "'\n";
+  out << "source_filename = \"" << llvmModule->getSourceFileName() << "\"\n";
+  out << "target datalayout = \"" << llvmModule->getDataLayoutStr() << "\"\n";
+  out << "target triple = \"" << llvmModule->getTargetTriple() << "\"\n";
+}
+
+void driver::stream_print (llvm::Function* F)
+{
+  // Printing scans the whole parent module, which would make streaming
+  // quadratic: print from the scratch module instead.  The slot tracker numbers
+  // metadata across the whole stream, so that definitions never clash.
+  F->removeFromParent();
+  stream_module->getFunctionList().push_back(F);
+
+  // Function::print hides the Value overload taking a slot tracker.
+  static_cast<llvm::Value*>(F)->print(*stream_out, *stream_slots);
+}
+
+void driver::stream_function (llvm::Function* F)
+{
+  *stream_out << "\n";
+  stream_print(F);
+
+  llvm::SmallVector<const llvm::MDNode*, 8> worklist;
+  llvm::SmallVector<std::pair<unsigned, llvm::MDNode*>, 4> attachments;
+  for (auto& BB : *F)
+    for (auto& I : BB) {
+      I.getAllMetadata(attachments);
+      for (auto& attachment : attachments)
+        worklist.push_back(attachment.second);
+    }
+
+  // Distinct nodes, such as loop IDs, belong to this function alone: only
+  // uniqued ones, which later functions may share, are remembered.
+  llvm::SmallPtrSet<const llvm::MDNode*, 8> printed;
+  for (unsigned i = 0; i < worklist.size(); ++i) {
+    const llvm::MDNode* node = worklist[i];
+    if (!printed.insert(node).second || streamed_metadata.count(node))
+      continue;
+    if (node->isUniqued())
+      streamed_metadata.insert(node);
+
+    node->print(*stream_out, *stream_slots, stream_module.get());
+    *stream_out << "\n";
+
+    for (auto& op : node->operands())
+      if (auto* child = llvm::dyn_cast_or_null<llvm::MDNode>(op.get()))
+        worklist.push_back(child);
+  }
+
+  // Only the type is kept, for later calls.  Nothing calls a top-level expression.
+  if (!F->getName().startswith("__anon_expr"))
+    streamedFunctions[F->getName()] = F->getFunctionType();
+  F->eraseFromParent();
+
+  // Drop the declarations getFunction created again for this function.
+  std::vector<llvm::Function*> redeclared;
+  for (auto& G : *llvmModule)
+    if (streamedFunctions.count(G.getName()))
+      redeclared.push_back(&G);
+  for (llvm::Function* G : redeclared)
+    G->eraseFromParent();
+}
+
+llvm::Function* driver::getFunction (llvm::StringRef name)
+{
+  if (llvm::Function* F = llvmModule->getFunction(name))
+    return F;
+
+  auto it = streamedFunctions.find(name);
+  if (it == streamedFunctions.end())
+    return nullptr;
+  return llvm::Function::Create(it->second, llvm::Function::ExternalLinkage, name, llvmModule.get());
+}
+
+void driver::stream_end ()
+{
+  *stream_out << "\n";
+
+  std::vector<llvm::Function*> declarations;
+  for (auto& F : *llvmModule)
+    if (!streamedFunctions.count(F.getName()))
+      declarations.push_back(&F);
+
+  // The tracker only numbers attribute groups when it first scans its module:
+  // start a new one once every declaration has been moved there.  No metadata is
+  // left to print, so restarting its numbering is harmless.
+  for (llvm::Function* F : declarations) {
+    F->removeFromParent();
+    stream_module->getFunctionList().push_back(F);
+  }
+
+  // Globals, such as the runtime's output buffer, are only ever declared.
+  while (!llvmModule->global_empty()) {
+    llvm::GlobalVariable* G = &*llvmModule->global_begin();
+    G->removeFromParent();
+    stream_module->getGlobalList().push_back(G);
+  }
+  stream_slots = std::make_unique<llvm::ModuleSlotTracker>(stream_module.get(), false);
+
+  for (auto& G : stream_module->globals()) {
+    static_cast<llvm::Value*>(&G)->print(*stream_out, *stream_slots);
+    *stream_out << "\n";
+  }
+  if (!stream_module->global_empty())
+    *stream_out << "\n";
+
+  for (auto& F : *stream_module)
+    static_cast<llvm::Value*>(&F)->print(*stream_out, *stream_slots);
+
+  // Only declarations carry function attributes.  Print their groups with the
+  // numbers the tracker gave them: in module order, as Module::print does.
+  std::vector<llvm::AttributeSet> groups;
+  for (auto& F : *stream_module) {
+    llvm::AttributeSet attributes = F.getAttributes().getFnAttrs();
+    if (attributes.hasAttributes() && std::find(groups.begin(), groups.end(), attributes) == groups.end())
+      groups.push_back(attributes);
+  }
+
+  if (!groups.empty())
+    *stream_out << "\n";
+  for (size_t i = 0; i < groups.size(); ++i)
+    *stream_out << "attributes #" << i << " = { " << groups[i].getAsString(true) << " }\n";
+
+  stream_out->flush();
+}
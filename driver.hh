@@ -3,34 +3,124 @@
 
 #include "parser.hh"
 #include <map>
+#include <utility>
+#include <vector>
+#include "llvm/ADT/StringRef.h"
 
 #include <memory>
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/ModuleSlotTracker.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/raw_ostream.h"
 
-# define YY_DECL yy::parser::symbol_type yylex(driver& drv)
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+# define YY_DECL yy::parser::symbol_type yylex(driver& drv, yyscan_t yyscanner)
 
 YY_DECL;
 
+class ConstEvaluator;
+class TieredEngine;
+
+// An array in scope: its elements, and its length as an i64.  static_length is 0 when
+// only known at run time.
+struct ArrayInfo {
+  llvm::Value* data;
+  llvm::Value* length;
+  uint64_t static_length;
+};
+
+// A for loop being lowered with an integer induction variable, in which var takes the
+// values of index.  Indexing array, or any array of at least bound elements, with var
+// is known to be in bounds.
+struct CountedLoop {
+  std::string var;
+  llvm::AllocaInst* index;
+  std::string array;
+  uint64_t bound;
+};
+
 class driver
 {
   unsigned long long unique_id;
 
 public:
   driver();
+  ~driver();
 
   std::unique_ptr<llvm::LLVMContext> llvmContext;
   std::unique_ptr<llvm::Module> llvmModule;
   std::unique_ptr<llvm::IRBuilder<>> llvmIRBuilder;
   std::map<const std::string, llvm::AllocaInst*> namedPointers;
+  std::map<std::string, ArrayInfo> namedArrays;
+  std::vector<CountedLoop> countedLoops;
+
+  // Create the LLVM context, module and builder.  Must be called before any codegen;
+  // the interpreter never does, so that it does not pay for them.
+  void init_codegen ();
+
+  // Whether calls with constant arguments are evaluated at compile time, and the
+  // evaluator doing it (created by init_codegen).
+  bool const_eval;
+  std::unique_ptr<ConstEvaluator> const_evaluator;
+
+  // Whether the program is linked with the kalcc runtime (runtime/kalrt.h), in which
+  // case calls to putchard append to its output buffer inline.
+  bool runtime_io;
+
+  // Called by the execution engines before they print a value, so that output the
+  // program left in a buffer comes first.
+  void (*flush_output)();
+
+  // Set while generating code for -tiered, along with the tier (0 or 2) being generated.
+  TieredEngine* tiered;
+  unsigned tier;
 
   std::unique_ptr<RootAST> root;
 
+  // Called by the parser for every top-level construct, in order, and once at the end of the input.
+  void top_level (std::unique_ptr<RootAST> top, const SourceRange& loc);
+  void end_program (const SourceRange& loc);
+
+  // Whether to lower each top-level construct as soon as it is parsed, printing finished
+  // functions to the stream and dropping them, instead of building root.
+  bool streaming;
+
+  // Functions already streamed out, with their types.  They are removed from the
+  // module, and only declared again while a later function calls them.
+  llvm::StringMap<llvm::FunctionType*> streamedFunctions;
+
+  // The function name of the module, declared again if it was streamed out.
+  llvm::Function* getFunction (llvm::StringRef name);
+
+  // Whether to drop, once the whole input is parsed, the definitions that cannot be
+  // reached from the top-level expressions or from exports.  Not available when streaming.
+  bool only_reachable;
+  std::vector<std::string> exports;
+
+  // The definitions dropped, in source order.
+  std::vector<std::string> skippedFunctions;
+
+  void stream_begin (llvm::raw_ostream& out);
+  void stream_end ();
+
   // Run the parser on file F.  Return 0 on success.
   int parse (const std::string& f);
 
+  // Run the parser on the in-memory SOURCE, reporting locations against NAME.  Return 0 on success.
+  int parse_string (llvm::StringRef source, const std::string& name);
+
+  // Errors reported while scanning and parsing, already formatted.
+  std::vector<std::string> diagnostics;
+
   unsigned long long get_unique_id();
 
   // The name of the file being parsed.
@@ -41,15 +131,42 @@ public:
 
   bool trace_codegen;
   
-  // Handling the scanner.
-  void scan_begin ();
+  // Handling the scanner.  Each driver owns a reentrant scanner instance.
+  yyscan_t scanner;
+  bool scan_begin ();
+  void scan_begin_string (llvm::StringRef source);
   void scan_end ();
   
   // Whether to generate scanner debug traces.
   bool trace_scanning;
   
   // The token's location used by the scanner.
-  yy::location location;
+  SourceRange location;
+
+  // Where the lines of file start, to turn offsets into lines and columns.
+  LineTable lines;
+
+  // Format range as "file:line.column-column" for diagnostics.
+  std::string describe (const SourceRange& range) const;
+
+private:
+  int run_parser ();
+
+  // Top-level constructs waiting to be chained into root, when not streaming.
+  std::vector<std::pair<std::unique_ptr<RootAST>, SourceRange>> pending;
+
+  llvm::raw_ostream* stream_out;
+  std::unique_ptr<llvm::Module> stream_module;
+  std::unique_ptr<llvm::ModuleSlotTracker> stream_slots;
+  llvm::SmallPtrSet<const llvm::MDNode*, 8> streamed_metadata;
+
+  void drop_unreachable ();
+
+  void stream_print (llvm::Function* F);
+  void stream_function (llvm::Function* F);
 };
 
+// The parser only knows about the driver: fetch the scanner from it.
+inline yy::parser::symbol_type yylex(driver& drv) { return yylex(drv, drv.scanner); }
+
 #endif // !DRIVER_HH
\ No newline at end of file
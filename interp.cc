@@ -0,0 +1,604 @@
+#include "interp.hh"
+#include "driver.hh"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+
+/* COMPILER */
+
+static inline void error(const location& loc, const std::string& message) {
+  throw codegen_error(loc, message);
+}
+
+BytecodeCompiler::BytecodeCompiler(driver& drv, BytecodeProgram& program, bool resolve_externs, bool metered)
+  : drv(drv),
+    program(program),
+    resolve_externs(resolve_externs),
+    metered(metered),
+    fn(nullptr),
+    top(0),
+    var_floor(0) {}
+
+unsigned BytecodeCompiler::declareFunction(const std::string& name, unsigned arity, const location& loc) {
+  auto it = this->program.function_index.find(name);
+  if (it != this->program.function_index.end()) {
+    if (this->program.functions[it->second].arity != arity)
+      error(loc, "Conflicting declaration of function " + name);
+    return it->second;
+  }
+
+  BytecodeFunction f;
+  f.name = name;
+  f.arity = arity;
+
+  this->program.functions.push_back(std::move(f));
+  unsigned index = this->program.functions.size() - 1;
+  this->program.function_index[name] = index;
+  return index;
+}
+
+void BytecodeCompiler::beginFunction(unsigned index, const std::vector<std::string>& args, const location& loc) {
+  this->fn = &this->program.functions[index];
+  if (this->fn->defined)
+    error(loc, "Redefinition of function " + this->fn->name);
+
+  this->variables.clear();
+  this->top = 0;
+  this->var_floor = 0;
+
+  // Arguments are passed in the first registers.
+  for (auto& arg : args)
+    this->createVar(arg, loc);
+}
+
+void BytecodeCompiler::endFunction(int result) {
+  this->emit(Opcode::Return, result);
+  this->fn->defined = true;
+  this->fn = nullptr;
+}
+
+int BytecodeCompiler::temp() {
+  int reg = this->top++;
+  this->fn->frame_size = std::max<unsigned>(this->fn->frame_size, this->top);
+  return reg;
+}
+
+void BytecodeCompiler::release(int mark) {
+  this->top = std::max(mark, this->var_floor);
+}
+
+int BytecodeCompiler::allocVar() {
+  int reg = this->temp();
+  this->var_floor = this->top;
+  return reg;
+}
+
+void BytecodeCompiler::nameVar(const std::string& name, int reg, const location& loc) {
+  if (!this->variables.emplace(name, reg).second)
+    error(loc, "Redefinition of variable " + name);
+}
+
+int BytecodeCompiler::createVar(const std::string& name, const location& loc) {
+  int reg = this->allocVar();
+  this->nameVar(name, reg, loc);
+  return reg;
+}
+
+int BytecodeCompiler::getVar(const std::string& name, const location& loc) {
+  auto it = this->variables.find(name);
+  if (it == this->variables.end())
+    error(loc, "Unknown variable name: " + name);
+  return it->second;
+}
+
+int BytecodeCompiler::constant(double value) {
+  auto& constants = this->fn->constants;
+  for (size_t i = 0; i < constants.size(); ++i)
+    if (constants[i] == value && std::signbit(constants[i]) == std::signbit(value))
+      return i;
+
+  constants.push_back(value);
+  return constants.size() - 1;
+}
+
+size_t BytecodeCompiler::emit(Opcode op, int a, int b, int c) {
+  this->fn->code.push_back({ op, a, b, c });
+  return this->fn->code.size() - 1;
+}
+
+void BytecodeCompiler::tick() {
+  if (this->metered)
+    this->emit(Opcode::Tick);
+}
+
+void BytecodeCompiler::patch(size_t jump, size_t target) {
+  this->fn->code[jump].c = target;
+}
+
+void BytecodeCompiler::patch(const std::vector<size_t>& jumps, size_t target) {
+  for (size_t jump : jumps)
+    this->patch(jump, target);
+}
+
+
+// Return a register holding the value of expr: variables are used in place
+// when nothing evaluated afterwards can assign them.
+static int operandReg(BytecodeCompiler& bc, ExprAST& expr, bool in_place) {
+  if (in_place)
+    if (VariableExprAST* var = dynamic_cast<VariableExprAST*>(&expr))
+      return bc.getVar(var->getName(), var->getLocation());
+
+  int reg = bc.temp();
+  expr.emitValue(bc, reg);
+  return reg;
+}
+
+static bool isLeaf(ExprAST& expr) {
+  return dynamic_cast<VariableExprAST*>(&expr) || dynamic_cast<NumberExprAST*>(&expr);
+}
+
+void ExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  error(this->getLocation(), "Expression not supported by the interpreter");
+}
+
+void ExprAST::emitCond(BytecodeCompiler& bc, bool jumpIf, std::vector<size_t>& jumps) {
+  int mark = bc.mark();
+  int reg = operandReg(bc, *this, true);
+  jumps.push_back(bc.emit(jumpIf ? Opcode::JumpIfTrue : Opcode::JumpIfFalse, reg));
+  bc.release(mark);
+}
+
+void VariableExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  bc.emit(Opcode::Move, dst, bc.getVar(this->name, this->getLocation()));
+}
+
+void NumberExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  bc.emit(Opcode::LoadConst, dst, bc.constant(this->value));
+}
+
+void BinaryExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  if (this->op == BinaryOperator::And || this->op == BinaryOperator::Or) {
+    // Materialize the outcome of the jumps as 1.0 or 0.0.
+    std::vector<size_t> toFalse;
+    this->emitCond(bc, false, toFalse);
+
+    bc.emit(Opcode::LoadConst, dst, bc.constant(1.0));
+    size_t toExit = bc.emit(Opcode::Jump);
+
+    bc.patch(toFalse, bc.here());
+    bc.emit(Opcode::LoadConst, dst, bc.constant(0.0));
+    bc.patch(toExit, bc.here());
+    return;
+  }
+
+  int mark = bc.mark();
+  int lhs = operandReg(bc, *this->lhs, isLeaf(*this->rhs));
+  int rhs = operandReg(bc, *this->rhs, true);
+
+  switch (this->op) {
+    case BinaryOperator::Add: bc.emit(Opcode::Add, dst, lhs, rhs); break;
+    case BinaryOperator::Sub: bc.emit(Opcode::Sub, dst, lhs, rhs); break;
+    case BinaryOperator::Mul: bc.emit(Opcode::Mul, dst, lhs, rhs); break;
+    case BinaryOperator::Div: bc.emit(Opcode::Div, dst, lhs, rhs); break;
+    case BinaryOperator::Lt: bc.emit(Opcode::Lt, dst, lhs, rhs); break;
+    case BinaryOperator::Lte: bc.emit(Opcode::Lte, dst, lhs, rhs); break;
+    case BinaryOperator::Gt: bc.emit(Opcode::Lt, dst, rhs, lhs); break;
+    case BinaryOperator::Gte: bc.emit(Opcode::Lte, dst, rhs, lhs); break;
+    case BinaryOperator::Eq: bc.emit(Opcode::Eq, dst, lhs, rhs); break;
+    case BinaryOperator::Neq: bc.emit(Opcode::Neq, dst, lhs, rhs); break;
+    default: assert(false);
+  }
+
+  bc.release(mark);
+}
+
+void BinaryExprAST::emitCond(BytecodeCompiler& bc, bool jumpIf, std::vector<size_t>& jumps) {
+  if (this->op == BinaryOperator::And || this->op == BinaryOperator::Or) {
+    // The lhs decides the result when it is false for "and", true for "or".
+    bool decides = this->op == BinaryOperator::Or;
+
+    if (jumpIf == decides) {
+      this->lhs->emitCond(bc, jumpIf, jumps);
+      this->rhs->emitCond(bc, jumpIf, jumps);
+    } else {
+      std::vector<size_t> skip;
+      this->lhs->emitCond(bc, decides, skip);
+      this->rhs->emitCond(bc, jumpIf, jumps);
+      bc.patch(skip, bc.here());
+    }
+    return;
+  }
+
+  Opcode jump;
+  bool swap = false;
+  switch (this->op) {
+    case BinaryOperator::Lt: jump = jumpIf ? Opcode::JumpIfLt : Opcode::JumpIfNotLt; break;
+    case BinaryOperator::Lte: jump = jumpIf ? Opcode::JumpIfLte : Opcode::JumpIfNotLte; break;
+    case BinaryOperator::Gt: jump = jumpIf ? Opcode::JumpIfLt : Opcode::JumpIfNotLt; swap = true; break;
+    case BinaryOperator::Gte: jump = jumpIf ? Opcode::JumpIfLte : Opcode::JumpIfNotLte; swap = true; break;
+    case BinaryOperator::Eq: jump = jumpIf ? Opcode::JumpIfEq : Opcode::JumpIfNotEq; break;
+    case BinaryOperator::Neq: jump = jumpIf ? Opcode::JumpIfNeq : Opcode::JumpIfNotNeq; break;
+    default:
+      ExprAST::emitCond(bc, jumpIf, jumps);
+      return;
+  }
+
+  int mark = bc.mark();
+  int lhs = operandReg(bc, *this->lhs, isLeaf(*this->rhs));
+  int rhs = operandReg(bc, *this->rhs, true);
+
+  if (swap)
+    std::swap(lhs, rhs);
+  jumps.push_back(bc.emit(jump, lhs, rhs));
+
+  bc.release(mark);
+}
+
+void UnaryExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  int mark = bc.mark();
+  int reg = operandReg(bc, *this->operand, true);
+
+  switch (this->op) {
+    case UnaryOperator::NumericNeg: bc.emit(Opcode::Neg, dst, reg); break;
+    case UnaryOperator::LogicalNot: bc.emit(Opcode::Not, dst, reg); break;
+  }
+
+  bc.release(mark);
+}
+
+void UnaryExprAST::emitCond(BytecodeCompiler& bc, bool jumpIf, std::vector<size_t>& jumps) {
+  if (this->op == UnaryOperator::LogicalNot)
+    this->operand->emitCond(bc, !jumpIf, jumps);
+  else
+    ExprAST::emitCond(bc, jumpIf, jumps);
+}
+
+void CallExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  BytecodeProgram& program = bc.getProgram();
+
+  auto it = program.function_index.find(this->callee);
+  if (it == program.function_index.end())
+    error(this->getLocation(), "Called unknown function " + this->callee);
+
+  unsigned arity = program.functions[it->second].arity;
+  if (arity != this->args.size())
+    error(this->getLocation(), "Function call argument count mismatch: expecting " + std::to_string(arity) + ", got " + std::to_string(this->args.size()));
+
+  // The arguments go in consecutive registers, which become the start of the callee's frame.
+  int mark = bc.mark();
+  int base = bc.mark();
+  for (size_t i = 0; i < this->args.size(); ++i)
+    bc.temp();
+
+  for (size_t i = 0; i < this->args.size(); ++i)
+    this->args[i]->emitValue(bc, base + i);
+
+  if (bc.mark() > base + (int) this->args.size()) {
+    // A variable declared in an argument lives above them: the callee would clobber it.
+    int moved = bc.mark();
+    for (size_t i = 0; i < this->args.size(); ++i)
+      bc.emit(Opcode::Move, bc.temp(), base + i);
+    base = moved;
+  }
+
+  bc.emit(Opcode::Call, dst, it->second, base);
+  bc.release(mark);
+}
+
+void IfExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  std::vector<size_t> toElse;
+  this->cond_expr->emitCond(bc, false, toElse);
+
+  this->then_expr->emitValue(bc, dst);
+  size_t toExit = bc.emit(Opcode::Jump);
+
+  bc.patch(toElse, bc.here());
+  this->else_expr->emitValue(bc, dst);
+
+  bc.patch(toExit, bc.here());
+}
+
+void CompositeExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  this->current->emitValue(bc, dst);
+
+  if (this->next)
+    this->next->emitValue(bc, dst);
+}
+
+void AssignmentExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  this->value_expr->emitValue(bc, dst);
+  bc.emit(Opcode::Move, bc.getVar(this->id_name, this->getLocation()), dst);
+}
+
+void ForExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  bc.createVar(this->init_expr->getDestinationName(), this->getLocation());
+
+  int mark = bc.mark();
+  this->init_expr->emitValue(bc, bc.temp());
+  bc.release(mark);
+
+  bc.emit(Opcode::LoadConst, dst, bc.constant(0.0));
+
+  // The condition is compiled before the body, as in codegen, so that it only
+  // sees the variables declared before it.
+  size_t header = bc.here();
+  std::vector<size_t> toExit;
+  this->cond_expr->emitCond(bc, false, toExit);
+  bc.tick();
+
+  this->body_expr->emitValue(bc, dst);
+
+  mark = bc.mark();
+  this->step_expr->emitValue(bc, bc.temp());
+  bc.release(mark);
+
+  bc.patch(bc.emit(Opcode::Jump), header);
+  bc.patch(toExit, bc.here());
+}
+
+void WhileExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  bc.emit(Opcode::LoadConst, dst, bc.constant(0.0));
+
+  size_t header = bc.here();
+  std::vector<size_t> toExit;
+  this->cond_expr->emitCond(bc, false, toExit);
+  bc.tick();
+
+  this->body_expr->emitValue(bc, dst);
+
+  bc.patch(bc.emit(Opcode::Jump), header);
+  bc.patch(toExit, bc.here());
+}
+
+void VarExprAST::emitValue(BytecodeCompiler& bc, int dst) {
+  for (auto &decl : this->declarations) {
+    int reg = bc.allocVar();
+    decl.second->emitValue(bc, reg);
+    bc.nameVar(decl.first, reg, this->getLocation());
+  }
+
+  this->body->emitValue(bc, dst);
+}
+
+void FunctionPrototypeAST::emit(BytecodeCompiler& bc) {
+  if (this->hasArrayArgs())
+    error(this->getLocation(), "Array parameters not supported by the interpreter");
+
+  unsigned index = bc.declareFunction(this->name, this->argsNames.size(), this->getLocation());
+
+  BytecodeFunction& fn = bc.getProgram().functions[index];
+  if (bc.resolvesExterns() && !fn.defined && !fn.native)
+    fn.native = dlsym(RTLD_DEFAULT, this->name.c_str());
+}
+
+void FunctionAST::emit(BytecodeCompiler& bc) {
+  if (this->prototype->hasArrayArgs())
+    error(this->getLocation(), "Array parameters not supported by the interpreter");
+
+  const std::vector<std::string>& args = this->prototype->getArgsNames();
+  unsigned index = bc.declareFunction(this->prototype->getName(), args.size(), this->getLocation());
+
+  bc.beginFunction(index, args, this->getLocation());
+  bc.tick();
+
+  int result = bc.temp();
+  this->body->emitValue(bc, result);
+
+  bc.endFunction(result);
+}
+
+void SequenceAST::emit(BytecodeCompiler& bc) {
+  for (SequenceAST* seq = this; seq; seq = seq->next.get()) {
+    if (!seq->current)
+      continue;
+
+    bool entry_point = dynamic_cast<ExprAST*>(seq->current.get()) != nullptr;
+
+    seq->current = makeTopLevelDefinition(bc.getDriver(), std::move(seq->current));
+    seq->current->emit(bc);
+
+    // The anonymous function was the last one declared.
+    if (entry_point)
+      bc.getProgram().entry_points.push_back(bc.getProgram().functions.size() - 1);
+  }
+}
+
+
+/* EXECUTION */
+
+Interpreter::Interpreter(const BytecodeProgram& program, size_t stack_size, unsigned max_depth)
+  : program(program),
+    stack(new double[stack_size]),
+    stack_end(stack.get() + stack_size),
+    max_depth(max_depth),
+    fuel(UINT64_MAX) {}
+
+static inline bool isTrue(double x) {
+  // Like "fcmp one x, 0": NaN is false.
+  return x < 0 || x > 0;
+}
+
+double Interpreter::callNative(const BytecodeFunction& fn, const double* a) {
+  if (!fn.native)
+    throw std::runtime_error("Unresolved external function " + fn.name);
+
+  typedef double D;
+  void* f = fn.native;
+  switch (fn.arity) {
+    case 0: return ((D (*)()) f)();
+    case 1: return ((D (*)(D)) f)(a[0]);
+    case 2: return ((D (*)(D, D)) f)(a[0], a[1]);
+    case 3: return ((D (*)(D, D, D)) f)(a[0], a[1], a[2]);
+    case 4: return ((D (*)(D, D, D, D)) f)(a[0], a[1], a[2], a[3]);
+    case 5: return ((D (*)(D, D, D, D, D)) f)(a[0], a[1], a[2], a[3], a[4]);
+    case 6: return ((D (*)(D, D, D, D, D, D)) f)(a[0], a[1], a[2], a[3], a[4], a[5]);
+    case 7: return ((D (*)(D, D, D, D, D, D, D)) f)(a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+    case 8: return ((D (*)(D, D, D, D, D, D, D, D)) f)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+    default:
+      throw std::runtime_error("Too many arguments for external function " + fn.name);
+  }
+}
+
+// Threaded dispatch through computed gotos where available, a switch otherwise.
+#if defined(__GNUC__)
+# define THREADED_DISPATCH 1
+#endif
+
+double Interpreter::execute(unsigned index, double* frame, unsigned depth) {
+  const BytecodeFunction& fn = this->program.functions[index];
+  if (!fn.defined)
+    return this->callNative(fn, frame);
+
+  if (depth >= this->max_depth || frame + fn.frame_size > this->stack_end)
+    throw std::runtime_error("Stack overflow calling " + fn.name);
+
+  const Instruction* code = fn.code.data();
+  const Instruction* ip = code;
+  const double* K = fn.constants.data();
+  double* R = frame;
+
+#if THREADED_DISPATCH
+  static void* const dispatch_table[] = {
+# define BYTECODE_LABEL(name) &&op_##name,
+    BYTECODE_OPCODES(BYTECODE_LABEL)
+# undef BYTECODE_LABEL
+  };
+# define DISPATCH() goto *dispatch_table[static_cast<int>(ip->op)]
+# define CASE(name) op_##name:
+  DISPATCH();
+#else
+# define DISPATCH() goto dispatch
+# define CASE(name) case Opcode::name:
+dispatch:
+  switch (ip->op) {
+#endif
+
+#define NEXT() do { ++ip; DISPATCH(); } while (0)
+#define JUMP_IF(cond) do { ip = (cond) ? code + ip->c : ip + 1; DISPATCH(); } while (0)
+
+  CASE(LoadConst)    R[ip->a] = K[ip->b]; NEXT();
+  CASE(Move)         R[ip->a] = R[ip->b]; NEXT();
+  CASE(Add)          R[ip->a] = R[ip->b] + R[ip->c]; NEXT();
+  CASE(Sub)          R[ip->a] = R[ip->b] - R[ip->c]; NEXT();
+  CASE(Mul)          R[ip->a] = R[ip->b] * R[ip->c]; NEXT();
+  CASE(Div)          R[ip->a] = R[ip->b] / R[ip->c]; NEXT();
+  CASE(Neg)          R[ip->a] = -R[ip->b]; NEXT();
+  CASE(Not)          R[ip->a] = !isTrue(R[ip->b]); NEXT();
+  CASE(Lt)           R[ip->a] = R[ip->b] < R[ip->c]; NEXT();
+  CASE(Lte)          R[ip->a] = R[ip->b] <= R[ip->c]; NEXT();
+  CASE(Eq)           R[ip->a] = R[ip->b] == R[ip->c]; NEXT();
+  CASE(Neq)          R[ip->a] = R[ip->b] < R[ip->c] || R[ip->b] > R[ip->c]; NEXT();
+  CASE(Jump)         ip = code + ip->c; DISPATCH();
+  CASE(JumpIfTrue)   JUMP_IF(isTrue(R[ip->a]));
+  CASE(JumpIfFalse)  JUMP_IF(!isTrue(R[ip->a]));
+  CASE(JumpIfLt)     JUMP_IF(R[ip->a] < R[ip->b]);
+  CASE(JumpIfNotLt)  JUMP_IF(!(R[ip->a] < R[ip->b]));
+  CASE(JumpIfLte)    JUMP_IF(R[ip->a] <= R[ip->b]);
+  CASE(JumpIfNotLte) JUMP_IF(!(R[ip->a] <= R[ip->b]));
+  CASE(JumpIfEq)     JUMP_IF(R[ip->a] == R[ip->b]);
+  CASE(JumpIfNotEq)  JUMP_IF(!(R[ip->a] == R[ip->b]));
+  CASE(JumpIfNeq)    JUMP_IF(R[ip->a] < R[ip->b] || R[ip->a] > R[ip->b]);
+  CASE(JumpIfNotNeq) JUMP_IF(!(R[ip->a] < R[ip->b] || R[ip->a] > R[ip->b]));
+  CASE(Call)         R[ip->a] = this->execute(ip->b, R + ip->c, depth + 1); NEXT();
+  CASE(Return)       return R[ip->a];
+  CASE(Tick)
+    if (this->fuel-- == 0)
+      throw std::runtime_error("Out of fuel running " + fn.name);
+    NEXT();
+
+#if !THREADED_DISPATCH
+  }
+#endif
+
+#undef JUMP_IF
+#undef NEXT
+#undef CASE
+#undef DISPATCH
+
+  assert(false);
+  return 0;
+}
+
+double Interpreter::call(unsigned index, const std::vector<double>& args) {
+  std::copy(args.begin(), args.end(), this->stack.get());
+  return this->execute(index, this->stack.get());
+}
+
+void interpret(driver& drv, RootAST& root) {
+  BytecodeProgram program;
+  BytecodeCompiler bc(drv, program);
+  root.emit(bc);
+
+  Interpreter interpreter(program);
+  for (unsigned entry : program.entry_points) {
+    double value = interpreter.call(entry, {});
+    if (drv.flush_output)
+      drv.flush_output();
+    std::printf("%f\n", value);
+  }
+}
+
+
+/* CONSTANT EVALUATION */
+
+const uint64_t ConstEvaluator::fuel;
+const uint64_t ConstEvaluator::total_fuel;
+const unsigned ConstEvaluator::max_depth;
+
+ConstEvaluator::ConstEvaluator(driver& drv)
+  : bc(drv, program, false, true) {}
+
+void ConstEvaluator::declare(FunctionPrototypeAST& prototype) {
+  try {
+    prototype.emit(this->bc);
+  } catch (codegen_error&) {
+    // Calls to it will not be evaluated.
+  }
+}
+
+void ConstEvaluator::define(FunctionAST& function) {
+  try {
+    function.emit(this->bc);
+  } catch (codegen_error&) {
+    // Left undefined: calls to it will not be evaluated.
+  }
+}
+
+bool ConstEvaluator::evaluate(const std::string& callee, const std::vector<double>& args, double& result) {
+  auto it = this->program.function_index.find(callee);
+  if (it == this->program.function_index.end() || !this->program.functions[it->second].defined)
+    return false;
+
+  std::vector<uint64_t> bits(args.size());
+  std::memcpy(bits.data(), args.data(), args.size() * sizeof(double));
+
+  auto cached = this->results.emplace(std::make_pair(it->second, std::move(bits)), std::make_pair(false, 0.0));
+  std::pair<bool, double>& entry = cached.first->second;
+  if (!cached.second) {
+    result = entry.second;
+    return entry.first;
+  }
+
+  if (this->spent >= total_fuel)
+    return false;
+
+  if (!this->interpreter)
+    this->interpreter = std::make_unique<Interpreter>(this->program, 1 << 16, max_depth);
+
+  uint64_t limit = std::min(fuel, total_fuel - this->spent);
+  this->interpreter->setFuel(limit);
+  try {
+    entry.second = this->interpreter->call(it->second, args);
+    entry.first = true;
+    this->spent += limit - this->interpreter->getFuel();
+  } catch (std::runtime_error&) {
+    // A call that fails is charged its whole limit.
+    this->spent += limit;
+  }
+
+  result = entry.second;
+  return entry.first;
+}
@@ -0,0 +1,183 @@
+#ifndef INTERP_HH
+#define INTERP_HH
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ast.hh"
+
+// A register-based bytecode interpreter, used by -interp to run programs
+// without going through LLVM at all.
+
+// Operands a, b, c are register indices, except where noted.
+#define BYTECODE_OPCODES(X) \
+  X(LoadConst)      /* a = constants[b] */ \
+  X(Move)           /* a = b */ \
+  X(Add)            /* a = b + c */ \
+  X(Sub)            \
+  X(Mul)            \
+  X(Div)            \
+  X(Neg)            /* a = -b */ \
+  X(Not)            /* a = b is false ? 1 : 0 */ \
+  X(Lt)             /* a = b < c ? 1 : 0 */ \
+  X(Lte)            \
+  X(Eq)             \
+  X(Neq)            \
+  X(Jump)           /* goto c */ \
+  X(JumpIfTrue)     /* if a is true goto c */ \
+  X(JumpIfFalse)    \
+  X(JumpIfLt)       /* if a < b goto c */ \
+  X(JumpIfNotLt)    /* if !(a < b) goto c */ \
+  X(JumpIfLte)      \
+  X(JumpIfNotLte)   \
+  X(JumpIfEq)       \
+  X(JumpIfNotEq)    \
+  X(JumpIfNeq)      \
+  X(JumpIfNotNeq)   \
+  X(Call)           /* a = functions[b](c, c + 1, ...) */ \
+  X(Return)         /* return a */ \
+  X(Tick)           /* consume one unit of fuel */
+
+enum class Opcode : uint8_t {
+#define BYTECODE_ENUM(name) name,
+  BYTECODE_OPCODES(BYTECODE_ENUM)
+#undef BYTECODE_ENUM
+};
+
+struct Instruction {
+  Opcode op;
+  int32_t a, b, c;
+};
+
+struct BytecodeFunction {
+  std::string name;
+  unsigned arity;
+
+  // Set once the body has been compiled; until then calls go to the native
+  // function of the same name, looked up when the extern is declared.
+  bool defined = false;
+  void* native = nullptr;
+
+  unsigned frame_size = 0;
+  std::vector<Instruction> code;
+  std::vector<double> constants;
+};
+
+struct BytecodeProgram {
+  std::vector<BytecodeFunction> functions;
+  std::map<std::string, unsigned> function_index;
+
+  // The functions wrapping top-level expressions, in source order.
+  std::vector<unsigned> entry_points;
+};
+
+
+// Translates the AST into a BytecodeProgram, one top-level construct at a time.
+class BytecodeCompiler {
+  driver& drv;
+  BytecodeProgram& program;
+
+  // Whether externs are looked up with dlsym, and whether loops and function
+  // entries consume fuel.
+  bool resolve_externs;
+  bool metered;
+
+  // State of the function being compiled.
+  BytecodeFunction* fn;
+  std::map<std::string, int> variables;
+  int top;        // first free register
+  int var_floor;  // registers below this one may hold variables
+
+public:
+  BytecodeCompiler(driver& drv, BytecodeProgram& program, bool resolve_externs = true, bool metered = false);
+
+  driver& getDriver() { return drv; }
+  BytecodeProgram& getProgram() { return program; }
+  bool resolvesExterns() const { return resolve_externs; }
+
+  unsigned declareFunction(const std::string& name, unsigned arity, const location& loc);
+  void beginFunction(unsigned index, const std::vector<std::string>& args, const location& loc);
+  void endFunction(int result);
+
+  // Temporaries are allocated as a stack: release everything above a mark when done.
+  int temp();
+  int mark() const { return top; }
+  void release(int mark);
+
+  // Variables are never released.  A register can be allocated before naming
+  // it, so that the initializer does not see the new variable.
+  int allocVar();
+  void nameVar(const std::string& name, int reg, const location& loc);
+  int createVar(const std::string& name, const location& loc);
+  int getVar(const std::string& name, const location& loc);
+
+  int constant(double value);
+  size_t emit(Opcode op, int a = 0, int b = 0, int c = 0);
+  void tick();
+
+  // Point the jump (or every jump in the list) at target, usually here().
+  size_t here() const { return fn->code.size(); }
+  void patch(size_t jump, size_t target);
+  void patch(const std::vector<size_t>& jumps, size_t target);
+};
+
+
+class Interpreter {
+  const BytecodeProgram& program;
+
+  std::unique_ptr<double[]> stack;
+  double* stack_end;
+  unsigned max_depth;
+  uint64_t fuel;
+
+  double callNative(const BytecodeFunction& fn, const double* args);
+
+public:
+  explicit Interpreter(const BytecodeProgram& program, size_t stack_size = 1 << 20, unsigned max_depth = 10000);
+
+  // Run function index with its arguments already stored at the start of frame.
+  double execute(unsigned index, double* frame, unsigned depth = 0);
+  double call(unsigned index, const std::vector<double>& args);
+
+  // The number of Tick instructions that may still run before execution is aborted.
+  void setFuel(uint64_t fuel) { this->fuel = fuel; }
+  uint64_t getFuel() const { return this->fuel; }
+};
+
+
+// Runs calls with constant arguments at compile time.  Functions are
+// compiled to metered bytecode as they are lowered; externs are never
+// called, so anything that performs I/O simply fails to evaluate.
+class ConstEvaluator {
+  BytecodeProgram program;
+  BytecodeCompiler bc;
+  std::unique_ptr<Interpreter> interpreter;
+
+  // Results of earlier calls, by callee and bit patterns of the arguments;
+  // calls that failed are kept too, so that they are not run again.
+  std::map<std::pair<unsigned, std::vector<uint64_t>>, std::pair<bool, double>> results;
+  uint64_t spent = 0;
+
+public:
+  // Limits for a single evaluation, and fuel for the whole compilation.
+  static const uint64_t fuel = 1 << 20;
+  static const uint64_t total_fuel = 1 << 24;
+  static const unsigned max_depth = 1000;
+
+  explicit ConstEvaluator(driver& drv);
+
+  void declare(FunctionPrototypeAST& prototype);
+  void define(FunctionAST& function);
+
+  // Return false if the call could not be evaluated within the limits.
+  bool evaluate(const std::string& callee, const std::vector<double>& args, double& result);
+};
+
+
+// Compile the whole program and run its top-level expressions in order,
+// printing their values.  Errors are thrown as std::runtime_error.
+void interpret(driver& drv, RootAST& root);
+
+#endif // !INTERP_HH
@@ -0,0 +1,64 @@
+#include "kalcc.hh"
+#include "driver.hh"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace kalcc {
+
+Result compile(llvm::StringRef source, const Options& options) {
+  Result result;
+
+  driver drv;
+  drv.trace_parsing = options.trace_parsing;
+  drv.trace_scanning = options.trace_scanning;
+  drv.trace_codegen = options.trace_codegen;
+  drv.const_eval = options.const_eval;
+  drv.only_reachable = options.only_reachable;
+  drv.runtime_io = options.runtime_io;
+  drv.exports = options.exports;
+  drv.init_codegen();
+  drv.llvmModule->setModuleIdentifier(options.name);
+  drv.llvmModule->setSourceFileName(options.name);
+
+  int ans = drv.parse_string(source, options.name);
+  result.diagnostics = std::move(drv.diagnostics);
+  result.skipped_functions = std::move(drv.skippedFunctions);
+
+  if (ans != 0) {
+    if (result.diagnostics.empty())
+      result.diagnostics.push_back(options.name + ": parsing failed");
+    return result;
+  }
+
+  try {
+    if (drv.root)
+      drv.root->codegen(drv, 0);
+  } catch (codegen_error& e) {
+    result.diagnostics.push_back(e.describe(drv));
+    return result;
+  }
+
+  result.context = std::move(drv.llvmContext);
+  result.module = std::move(drv.llvmModule);
+  return result;
+}
+
+std::string Result::bitcode() const {
+  std::string out;
+  if (module) {
+    llvm::raw_string_ostream os(out);
+    llvm::WriteBitcodeToFile(*module, os);
+  }
+  return out;
+}
+
+std::string Result::ir() const {
+  std::string out;
+  if (module) {
+    llvm::raw_string_ostream os(out);
+    module->print(os, nullptr);
+  }
+  return out;
+}
+
+}
@@ -0,0 +1,58 @@
+#ifndef KALCC_HH
+#define KALCC_HH
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/ADT/StringRef.h"
+
+// Embeddable compiler API.
+// Every call to compile() uses its own scanner, parser and LLVMContext, so
+// independent compilations can safely run concurrently on different threads.
+namespace kalcc {
+
+struct Options {
+  // The name reported in diagnostics and used as the module identifier.
+  std::string name = "<input>";
+
+  // Debug traces are written to stderr.
+  bool trace_parsing = false;
+  bool trace_scanning = false;
+  bool trace_codegen = false;
+
+  // Evaluate calls with constant arguments at compile time.
+  bool const_eval = true;
+
+  // Only lower the functions reachable from top-level expressions and from exports.
+  bool only_reachable = false;
+  std::vector<std::string> exports;
+
+  // Inline the fast path of putchard into the buffer of the kalcc runtime, which the
+  // program must then be linked with (libkalrt.a).
+  bool runtime_io = false;
+};
+
+struct Result {
+  // The module is only set when compilation succeeded, and it lives in context.
+  std::unique_ptr<llvm::LLVMContext> context;
+  std::unique_ptr<llvm::Module> module;
+
+  std::vector<std::string> diagnostics;
+
+  // With only_reachable, the definitions that were not lowered.
+  std::vector<std::string> skipped_functions;
+
+  bool ok() const { return module != nullptr; }
+
+  // Serialize the module as LLVM bitcode or textual IR.
+  std::string bitcode() const;
+  std::string ir() const;
+};
+
+Result compile(llvm::StringRef source, const Options& options = Options());
+
+}
+
+#endif // !KALCC_HH
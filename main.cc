@@ -1,4 +1,7 @@
 #include "driver.hh"
+#include "interp.hh"
+#include "tiered.hh"
+#include "runtime/kalrt.h"
 
 int main(int argc, char* argv[]) {
   if (argc <= 1) {
@@ -7,6 +10,8 @@ int main(int argc, char* argv[]) {
   }
 
   driver drv;
+  bool interp = false;
+  bool tiered = false;
 
   for (int i = 2; i < argc; ++i) {
     std::string arg = std::string(argv[i]);
@@ -16,24 +21,93 @@ int main(int argc, char* argv[]) {
       drv.trace_parsing = true;
     else if (arg == "-ts")
       drv.trace_scanning = true;
+    else if (arg == "-stream")
+      drv.streaming = true;
+    else if (arg == "-interp")
+      interp = true;
+    else if (arg == "-tiered")
+      tiered = true;
+    else if (arg == "-no-ctfe")
+      drv.const_eval = false;
+    else if (arg == "-runtime")
+      drv.runtime_io = true;
+    else if (arg == "-reachable")
+      drv.only_reachable = true;
+    else if (arg == "-export") {
+      // A comma-separated list of function names, also implying -reachable.
+      if (i + 1 == argc) {
+        llvm::errs() << "-export needs a list of function names\n";
+        return 1;
+      }
+
+      llvm::SmallVector<llvm::StringRef, 8> names;
+      llvm::StringRef(argv[++i]).split(names, ',', -1, false);
+      for (auto name : names)
+        drv.exports.push_back(name.str());
+      drv.only_reachable = true;
+    }
+    else {
+      llvm::errs() << "Unknown option " << arg << "\n";
+      return 1;
+    }
   }
 
-  int ans = drv.parse(std::string(argv[1]));
-  if (ans == 0) {
-    std::string error = "";
+  // Both execution engines run the whole program at the end; the interpreter needs no LLVM module.
+  if (interp || tiered || drv.only_reachable)
+    drv.streaming = false;
+  // Constant evaluation keeps bytecode for every function, which streaming must not.
+  if (drv.streaming)
+    drv.const_eval = false;
+  if (!interp)
+    drv.init_codegen();
+
+  // The runtime is linked into kalcc and exported, for -interp and -tiered.
+  drv.flush_output = [] { flush(); };
+
+  if (drv.streaming)
+    drv.stream_begin(llvm::outs());
 
-    try {
-      drv.root->codegen(drv, 0);
-    } catch (std::string& s) {
-      error = s;
+  int ans;
+  std::string error = "";
+
+  try {
+    ans = drv.parse(std::string(argv[1]));
+    if (ans == 0 && !drv.streaming && drv.root) {
+      if (interp)
+        interpret(drv, *drv.root);
+      else if (tiered)
+        TieredEngine(drv).run(*drv.root);
+      else
+        drv.root->codegen(drv, 0);
     }
+  } catch (codegen_error& e) {
+    ans = 0;
+    error = e.describe(drv);
+  } catch (std::runtime_error& e) {
+    // Raised by the execution engines.
+    ans = 0;
+    error = e.what();
+  }
+
+  for (auto& diagnostic : drv.diagnostics)
+    llvm::errs() << diagnostic << "\n";
 
+  if (!drv.skippedFunctions.empty()) {
+    llvm::errs() << "Skipped " << drv.skippedFunctions.size() << " unreachable function(s):";
+    for (auto& name : drv.skippedFunctions)
+      llvm::errs() << " " << name;
+    llvm::errs() << "\n";
+  }
+
+  if (ans == 0) {
     if (drv.trace_codegen || drv.trace_parsing || drv.trace_scanning)
       llvm::errs() << "\n";
 
     if (error != "")
       llvm::errs() << "Error: " << error << "\n";
-    else
+    else if (drv.streaming)
+      drv.stream_end();
+    else if (!interp && !tiered)
       drv.llvmModule->print(llvm::outs(), nullptr);
   }
   else
@@ -0,0 +1,1910 @@
+// A Bison parser, made by GNU Bison 3.8.2.
+
+// Skeleton implementation for Bison LALR(1) parsers in C++
+
+// Copyright (C) 2002-2015, 2018-2021 Free Software Foundation, Inc.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// As a special exception, you may create a larger work that contains
+// part or all of the Bison parser skeleton and distribute that work
+// under terms of your choice, so long as that work isn't itself a
+// parser generator using the skeleton or a modified version thereof
+// as a parser skeleton.  Alternatively, if you modify or redistribute
+// the parser skeleton itself, you may (at your option) remove this
+// special exception, which will cause the skeleton and the resulting
+// Bison output files to be licensed under the GNU General Public
+// License without this special exception.
+
+// This special exception was added by the Free Software Foundation in
+// version 2.2 of Bison.
+
+// DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+// especially those whose name start with YY_ or yy_.  They are
+// private implementation details that can be changed or removed.
+
+
+
+
+
+#include "parser.hh"
+
+
+// Unqualified %code blocks.
+#line 21 "parser.yy"
+
+  #include <algorithm>
+  #include <climits>
+  #include "driver.hh"
+
+  // Merge the pragma "@name" or "@name(arg)" into pragmas, rejecting malformed or conflicting ones.
+  static void applyLoopPragma(LoopPragmas& pragmas, const std::string& name, const double* arg, const SourceRange& loc)
+  {
+    unsigned count = 0;
+    if (arg) {
+      if (!(*arg >= 1 && *arg <= UINT_MAX) || *arg != (unsigned) *arg)
+        throw yy::parser::syntax_error(loc, "Argument of @" + name + " must be a positive integer");
+      count = (unsigned) *arg;
+    }
+
+    if (name == "unroll" || name == "nounroll") {
+      if (pragmas.unroll || pragmas.unroll_disable)
+        throw yy::parser::syntax_error(loc, "Duplicate unroll pragma on loop");
+      if (name == "nounroll" && arg)
+        throw yy::parser::syntax_error(loc, "@nounroll takes no argument");
+
+      pragmas.unroll = name == "unroll";
+      pragmas.unroll_disable = name == "nounroll";
+      pragmas.unroll_count = count;
+    }
+    else if (name == "vectorize" || name == "novectorize") {
+      if (pragmas.vectorize || pragmas.vectorize_disable)
+        throw yy::parser::syntax_error(loc, "Duplicate vectorize pragma on loop");
+      if (name == "novectorize" && arg)
+        throw yy::parser::syntax_error(loc, "@novectorize takes no argument");
+      if (count & (count - 1))
+        throw yy::parser::syntax_error(loc, "Vectorization width must be a power of two");
+
+      pragmas.vectorize = name == "vectorize";
+      pragmas.vectorize_disable = name == "novectorize";
+      pragmas.vectorize_width = count;
+    }
+    else
+      throw yy::parser::syntax_error(loc, "Unknown loop pragma: @" + name);
+  }
+
+  // Build a prototype from its parameters, each paired with whether it is an array.
+  static std::unique_ptr<FunctionPrototypeAST> makePrototype(const std::string& name, const std::vector<std::pair<std::string, bool>>& params, const SourceRange& loc)
+  {
+    std::vector<std::string> names;
+    std::vector<bool> arrays;
+    for (auto& param : params) {
+      names.push_back(param.first);
+      arrays.push_back(param.second);
+    }
+
+    if (std::find(arrays.begin(), arrays.end(), true) == arrays.end())
+      arrays.clear();
+    return std::make_unique<FunctionPrototypeAST>(name, std::move(names), loc, std::move(arrays));
+  }
+
+#line 103 "parser.cc"
+
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> // FIXME: INFRINGES ON USER NAME SPACE.
+#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(msgid) msgid
+# endif
+#endif
+
+
+// Whether we are compiled with exception support.
+#ifndef YY_EXCEPTIONS
+# if defined __GNUC__ && !defined __EXCEPTIONS
+#  define YY_EXCEPTIONS 0
+# else
+#  define YY_EXCEPTIONS 1
+# endif
+#endif
+
+#define YYRHSLOC(Rhs, K) ((Rhs)[K].location)
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+# ifndef YYLLOC_DEFAULT
+#  define YYLLOC_DEFAULT(Current, Rhs, N)                               \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).begin  = YYRHSLOC (Rhs, 1).begin;                   \
+          (Current).end    = YYRHSLOC (Rhs, N).end;                     \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).begin = (Current).end = YYRHSLOC (Rhs, 0).end;      \
+        }                                                               \
+    while (false)
+# endif
+
+
+// Enable debugging if requested.
+#if YYDEBUG
+
+// A pseudo ostream that takes yydebug_ into account.
+# define YYCDEBUG if (yydebug_) (*yycdebug_)
+
+# define YY_SYMBOL_PRINT(Title, Symbol)         \
+  do {                                          \
+    if (yydebug_)                               \
+    {                                           \
+      *yycdebug_ << Title << ' ';               \
+      yy_print_ (*yycdebug_, Symbol);           \
+      *yycdebug_ << '\n';                       \
+    }                                           \
+  } while (false)
+
+# define YY_REDUCE_PRINT(Rule)          \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_reduce_print_ (Rule);          \
+  } while (false)
+
+# define YY_STACK_PRINT()               \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_stack_print_ ();                \
+  } while (false)
+
+#else // !YYDEBUG
+
+# define YYCDEBUG if (false) std::cerr
+# define YY_SYMBOL_PRINT(Title, Symbol)  YY_USE (Symbol)
+# define YY_REDUCE_PRINT(Rule)           static_cast<void> (0)
+# define YY_STACK_PRINT()                static_cast<void> (0)
+
+#endif // !YYDEBUG
+
+#define yyerrok         (yyerrstatus_ = 0)
+#define yyclearin       (yyla.clear ())
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYRECOVERING()  (!!yyerrstatus_)
+
+namespace yy {
+#line 195 "parser.cc"
+
+  /// Build a parser object.
+  parser::parser (driver& drv_yyarg)
+#if YYDEBUG
+    : yydebug_ (false),
+      yycdebug_ (&std::cerr),
+#else
+    :
+#endif
+      yy_lac_established_ (false),
+      drv (drv_yyarg)
+  {}
+
+  parser::~parser ()
+  {}
+
+  parser::syntax_error::~syntax_error () YY_NOEXCEPT YY_NOTHROW
+  {}
+
+  /*---------.
+  | symbol.  |
+  `---------*/
+
+
+
+  // by_state.
+  parser::by_state::by_state () YY_NOEXCEPT
+    : state (empty_state)
+  {}
+
+  parser::by_state::by_state (const by_state& that) YY_NOEXCEPT
+    : state (that.state)
+  {}
+
+  void
+  parser::by_state::clear () YY_NOEXCEPT
+  {
+    state = empty_state;
+  }
+
+  void
+  parser::by_state::move (by_state& that)
+  {
+    state = that.state;
+    that.clear ();
+  }
+
+  parser::by_state::by_state (state_type s) YY_NOEXCEPT
+    : state (s)
+  {}
+
+  parser::symbol_kind_type
+  parser::by_state::kind () const YY_NOEXCEPT
+  {
+    if (state == empty_state)
+      return symbol_kind::S_YYEMPTY;
+    else
+      return YY_CAST (symbol_kind_type, yystos_[+state]);
+  }
+
+  parser::stack_symbol_type::stack_symbol_type ()
+  {}
+
+  parser::stack_symbol_type::stack_symbol_type (YY_RVREF (stack_symbol_type) that)
+    : super_type (YY_MOVE (that.state), YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_loop_pragmas: // loop_pragmas
+        value.YY_MOVE_OR_COPY< LoopPragmas > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        value.YY_MOVE_OR_COPY< double > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_varlist_var: // varlist_var
+        value.YY_MOVE_OR_COPY< std::pair<std::string, std::unique_ptr<ExprAST>> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "id"
+      case symbol_kind::S_PRAGMA: // "pragma"
+      case symbol_kind::S_PRAGMA_ARGS: // "pragma("
+        value.YY_MOVE_OR_COPY< std::string > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_for_step: // for_step
+      case symbol_kind::S_identifier_expr: // identifier_expr
+        value.YY_MOVE_OR_COPY< std::unique_ptr<ExprAST> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_fun_def: // fun_def
+        value.YY_MOVE_OR_COPY< std::unique_ptr<FunctionAST> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_fun_proto: // fun_proto
+      case symbol_kind::S_fun_ext: // fun_ext
+        value.YY_MOVE_OR_COPY< std::unique_ptr<FunctionPrototypeAST> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_top: // top
+        value.YY_MOVE_OR_COPY< std::unique_ptr<RootAST> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_fun_proto_params: // fun_proto_params
+        value.YY_MOVE_OR_COPY< std::vector<std::pair<std::string, bool>> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_varlist: // varlist
+        value.YY_MOVE_OR_COPY< std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_opt_expr_list: // opt_expr_list
+      case symbol_kind::S_expr_list: // expr_list
+        value.YY_MOVE_OR_COPY< std::vector<std::unique_ptr<ExprAST>> > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+#if 201103L <= YY_CPLUSPLUS
+    // that is emptied.
+    that.state = empty_state;
+#endif
+  }
+
+  parser::stack_symbol_type::stack_symbol_type (state_type s, YY_MOVE_REF (symbol_type) that)
+    : super_type (s, YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_loop_pragmas: // loop_pragmas
+        value.move< LoopPragmas > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        value.move< double > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_varlist_var: // varlist_var
+        value.move< std::pair<std::string, std::unique_ptr<ExprAST>> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "id"
+      case symbol_kind::S_PRAGMA: // "pragma"
+      case symbol_kind::S_PRAGMA_ARGS: // "pragma("
+        value.move< std::string > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_for_step: // for_step
+      case symbol_kind::S_identifier_expr: // identifier_expr
+        value.move< std::unique_ptr<ExprAST> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_fun_def: // fun_def
+        value.move< std::unique_ptr<FunctionAST> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_fun_proto: // fun_proto
+      case symbol_kind::S_fun_ext: // fun_ext
+        value.move< std::unique_ptr<FunctionPrototypeAST> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_top: // top
+        value.move< std::unique_ptr<RootAST> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_fun_proto_params: // fun_proto_params
+        value.move< std::vector<std::pair<std::string, bool>> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_varlist: // varlist
+        value.move< std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_opt_expr_list: // opt_expr_list
+      case symbol_kind::S_expr_list: // expr_list
+        value.move< std::vector<std::unique_ptr<ExprAST>> > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+    // that is emptied.
+    that.kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+#if YY_CPLUSPLUS < 201103L
+  parser::stack_symbol_type&
+  parser::stack_symbol_type::operator= (const stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_loop_pragmas: // loop_pragmas
+        value.copy< LoopPragmas > (that.value);
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        value.copy< double > (that.value);
+        break;
+
+      case symbol_kind::S_varlist_var: // varlist_var
+        value.copy< std::pair<std::string, std::unique_ptr<ExprAST>> > (that.value);
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "id"
+      case symbol_kind::S_PRAGMA: // "pragma"
+      case symbol_kind::S_PRAGMA_ARGS: // "pragma("
+        value.copy< std::string > (that.value);
+        break;
+
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_for_step: // for_step
+      case symbol_kind::S_identifier_expr: // identifier_expr
+        value.copy< std::unique_ptr<ExprAST> > (that.value);
+        break;
+
+      case symbol_kind::S_fun_def: // fun_def
+        value.copy< std::unique_ptr<FunctionAST> > (that.value);
+        break;
+
+      case symbol_kind::S_fun_proto: // fun_proto
+      case symbol_kind::S_fun_ext: // fun_ext
+        value.copy< std::unique_ptr<FunctionPrototypeAST> > (that.value);
+        break;
+
+      case symbol_kind::S_top: // top
+        value.copy< std::unique_ptr<RootAST> > (that.value);
+        break;
+
+      case symbol_kind::S_fun_proto_params: // fun_proto_params
+        value.copy< std::vector<std::pair<std::string, bool>> > (that.value);
+        break;
+
+      case symbol_kind::S_varlist: // varlist
+        value.copy< std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > (that.value);
+        break;
+
+      case symbol_kind::S_opt_expr_list: // opt_expr_list
+      case symbol_kind::S_expr_list: // expr_list
+        value.copy< std::vector<std::unique_ptr<ExprAST>> > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    return *this;
+  }
+
+  parser::stack_symbol_type&
+  parser::stack_symbol_type::operator= (stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_loop_pragmas: // loop_pragmas
+        value.move< LoopPragmas > (that.value);
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        value.move< double > (that.value);
+        break;
+
+      case symbol_kind::S_varlist_var: // varlist_var
+        value.move< std::pair<std::string, std::unique_ptr<ExprAST>> > (that.value);
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "id"
+      case symbol_kind::S_PRAGMA: // "pragma"
+      case symbol_kind::S_PRAGMA_ARGS: // "pragma("
+        value.move< std::string > (that.value);
+        break;
+
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_for_step: // for_step
+      case symbol_kind::S_identifier_expr: // identifier_expr
+        value.move< std::unique_ptr<ExprAST> > (that.value);
+        break;
+
+      case symbol_kind::S_fun_def: // fun_def
+        value.move< std::unique_ptr<FunctionAST> > (that.value);
+        break;
+
+      case symbol_kind::S_fun_proto: // fun_proto
+      case symbol_kind::S_fun_ext: // fun_ext
+        value.move< std::unique_ptr<FunctionPrototypeAST> > (that.value);
+        break;
+
+      case symbol_kind::S_top: // top
+        value.move< std::unique_ptr<RootAST> > (that.value);
+        break;
+
+      case symbol_kind::S_fun_proto_params: // fun_proto_params
+        value.move< std::vector<std::pair<std::string, bool>> > (that.value);
+        break;
+
+      case symbol_kind::S_varlist: // varlist
+        value.move< std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > (that.value);
+        break;
+
+      case symbol_kind::S_opt_expr_list: // opt_expr_list
+      case symbol_kind::S_expr_list: // expr_list
+        value.move< std::vector<std::unique_ptr<ExprAST>> > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    // that is emptied.
+    that.state = empty_state;
+    return *this;
+  }
+#endif
+
+  template <typename Base>
+  void
+  parser::yy_destroy_ (const char* yymsg, basic_symbol<Base>& yysym) const
+  {
+    if (yymsg)
+      YY_SYMBOL_PRINT (yymsg, yysym);
+  }
+
+#if YYDEBUG
+  template <typename Base>
+  void
+  parser::yy_print_ (std::ostream& yyo, const basic_symbol<Base>& yysym) const
+  {
+    std::ostream& yyoutput = yyo;
+    YY_USE (yyoutput);
+    if (yysym.empty ())
+      yyo << "empty symbol";
+    else
+      {
+        symbol_kind_type yykind = yysym.kind ();
+        yyo << (yykind < YYNTOKENS ? "token" : "nterm")
+            << ' ' << yysym.name () << " ("
+            << yysym.location << ": ";
+        YY_USE (yykind);
+        yyo << ')';
+      }
+  }
+#endif
+
+  void
+  parser::yypush_ (const char* m, YY_MOVE_REF (stack_symbol_type) sym)
+  {
+    if (m)
+      YY_SYMBOL_PRINT (m, sym);
+    yystack_.push (YY_MOVE (sym));
+  }
+
+  void
+  parser::yypush_ (const char* m, state_type s, YY_MOVE_REF (symbol_type) sym)
+  {
+#if 201103L <= YY_CPLUSPLUS
+    yypush_ (m, stack_symbol_type (s, std::move (sym)));
+#else
+    stack_symbol_type ss (s, sym);
+    yypush_ (m, ss);
+#endif
+  }
+
+  void
+  parser::yypop_ (int n) YY_NOEXCEPT
+  {
+    yystack_.pop (n);
+  }
+
+#if YYDEBUG
+  std::ostream&
+  parser::debug_stream () const
+  {
+    return *yycdebug_;
+  }
+
+  void
+  parser::set_debug_stream (std::ostream& o)
+  {
+    yycdebug_ = &o;
+  }
+
+
+  parser::debug_level_type
+  parser::debug_level () const
+  {
+    return yydebug_;
+  }
+
+  void
+  parser::set_debug_level (debug_level_type l)
+  {
+    yydebug_ = l;
+  }
+#endif // YYDEBUG
+
+  parser::state_type
+  parser::yy_lr_goto_state_ (state_type yystate, int yysym)
+  {
+    int yyr = yypgoto_[yysym - YYNTOKENS] + yystate;
+    if (0 <= yyr && yyr <= yylast_ && yycheck_[yyr] == yystate)
+      return yytable_[yyr];
+    else
+      return yydefgoto_[yysym - YYNTOKENS];
+  }
+
+  bool
+  parser::yy_pact_value_is_default_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yypact_ninf_;
+  }
+
+  bool
+  parser::yy_table_value_is_error_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yytable_ninf_;
+  }
+
+  int
+  parser::operator() ()
+  {
+    return parse ();
+  }
+
+  int
+  parser::parse ()
+  {
+    int yyn;
+    /// Length of the RHS of the rule being reduced.
+    int yylen = 0;
+
+    // Error handling.
+    int yynerrs_ = 0;
+    int yyerrstatus_ = 0;
+
+    /// The lookahead symbol.
+    symbol_type yyla;
+
+    /// The locations where the error started and ended.
+    stack_symbol_type yyerror_range[3];
+
+    /// The return value of parse ().
+    int yyresult;
+
+    // Discard the LAC context in case there still is one left from a
+    // previous invocation.
+    yy_lac_discard_ ("init");
+
+#if YY_EXCEPTIONS
+    try
+#endif // YY_EXCEPTIONS
+      {
+    YYCDEBUG << "Starting parse\n";
+
+
+    /* Initialize the stack.  The initial state will be set in
+       yynewstate, since the latter expects the semantical and the
+       location values to have been already stored, initialize these
+       stacks with a primary value.  */
+    yystack_.clear ();
+    yypush_ (YY_NULLPTR, 0, YY_MOVE (yyla));
+
+  /*-----------------------------------------------.
+  | yynewstate -- push a new symbol on the stack.  |
+  `-----------------------------------------------*/
+  yynewstate:
+    YYCDEBUG << "Entering state " << int (yystack_[0].state) << '\n';
+    YY_STACK_PRINT ();
+
+    // Accept?
+    if (yystack_[0].state == yyfinal_)
+      YYACCEPT;
+
+    goto yybackup;
+
+
+  /*-----------.
+  | yybackup.  |
+  `-----------*/
+  yybackup:
+    // Try to take a decision without lookahead.
+    yyn = yypact_[+yystack_[0].state];
+    if (yy_pact_value_is_default_ (yyn))
+      goto yydefault;
+
+    // Read a lookahead token.
+    if (yyla.empty ())
+      {
+        YYCDEBUG << "Reading a token\n";
+#if YY_EXCEPTIONS
+        try
+#endif // YY_EXCEPTIONS
+          {
+            symbol_type yylookahead (yylex (drv));
+            yyla.move (yylookahead);
+          }
+#if YY_EXCEPTIONS
+        catch (const syntax_error& yyexc)
+          {
+            YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+            error (yyexc);
+            goto yyerrlab1;
+          }
+#endif // YY_EXCEPTIONS
+      }
+    YY_SYMBOL_PRINT ("Next token is", yyla);
+
+    if (yyla.kind () == symbol_kind::S_YYerror)
+    {
+      // The scanner already issued an error message, process directly
+      // to error recovery.  But do not keep the error token as
+      // lookahead, it is too special and may lead us to an endless
+      // loop in error recovery. */
+      yyla.kind_ = symbol_kind::S_YYUNDEF;
+      goto yyerrlab1;
+    }
+
+    /* If the proper action on seeing token YYLA.TYPE is to reduce or
+       to detect an error, take that action.  */
+    yyn += yyla.kind ();
+    if (yyn < 0 || yylast_ < yyn || yycheck_[yyn] != yyla.kind ())
+      {
+        if (!yy_lac_establish_ (yyla.kind ()))
+          goto yyerrlab;
+        goto yydefault;
+      }
+
+    // Reduce or error.
+    yyn = yytable_[yyn];
+    if (yyn <= 0)
+      {
+        if (yy_table_value_is_error_ (yyn))
+          goto yyerrlab;
+        if (!yy_lac_establish_ (yyla.kind ()))
+          goto yyerrlab;
+
+        yyn = -yyn;
+        goto yyreduce;
+      }
+
+    // Count tokens shifted since error; after three, turn off error status.
+    if (yyerrstatus_)
+      --yyerrstatus_;
+
+    // Shift the lookahead token.
+    yypush_ ("Shifting", state_type (yyn), YY_MOVE (yyla));
+    yy_lac_discard_ ("shift");
+    goto yynewstate;
+
+
+  /*-----------------------------------------------------------.
+  | yydefault -- do the default action for the current state.  |
+  `-----------------------------------------------------------*/
+  yydefault:
+    yyn = yydefact_[+yystack_[0].state];
+    if (yyn == 0)
+      goto yyerrlab;
+    goto yyreduce;
+
+
+  /*-----------------------------.
+  | yyreduce -- do a reduction.  |
+  `-----------------------------*/
+  yyreduce:
+    yylen = yyr2_[yyn];
+    {
+      stack_symbol_type yylhs;
+      yylhs.state = yy_lr_goto_state_ (yystack_[yylen].state, yyr1_[yyn]);
+      /* Variants are always initialized to an empty instance of the
+         correct type. The default '$$ = $1' action is NOT applied
+         when using variants.  */
+      switch (yyr1_[yyn])
+    {
+      case symbol_kind::S_loop_pragmas: // loop_pragmas
+        yylhs.value.emplace< LoopPragmas > ();
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        yylhs.value.emplace< double > ();
+        break;
+
+      case symbol_kind::S_varlist_var: // varlist_var
+        yylhs.value.emplace< std::pair<std::string, std::unique_ptr<ExprAST>> > ();
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "id"
+      case symbol_kind::S_PRAGMA: // "pragma"
+      case symbol_kind::S_PRAGMA_ARGS: // "pragma("
+        yylhs.value.emplace< std::string > ();
+        break;
+
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_for_step: // for_step
+      case symbol_kind::S_identifier_expr: // identifier_expr
+        yylhs.value.emplace< std::unique_ptr<ExprAST> > ();
+        break;
+
+      case symbol_kind::S_fun_def: // fun_def
+        yylhs.value.emplace< std::unique_ptr<FunctionAST> > ();
+        break;
+
+      case symbol_kind::S_fun_proto: // fun_proto
+      case symbol_kind::S_fun_ext: // fun_ext
+        yylhs.value.emplace< std::unique_ptr<FunctionPrototypeAST> > ();
+        break;
+
+      case symbol_kind::S_top: // top
+        yylhs.value.emplace< std::unique_ptr<RootAST> > ();
+        break;
+
+      case symbol_kind::S_fun_proto_params: // fun_proto_params
+        yylhs.value.emplace< std::vector<std::pair<std::string, bool>> > ();
+        break;
+
+      case symbol_kind::S_varlist: // varlist
+        yylhs.value.emplace< std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > ();
+        break;
+
+      case symbol_kind::S_opt_expr_list: // opt_expr_list
+      case symbol_kind::S_expr_list: // expr_list
+        yylhs.value.emplace< std::vector<std::unique_ptr<ExprAST>> > ();
+        break;
+
+      default:
+        break;
+    }
+
+
+      // Default location.
+      {
+        stack_type::slice range (yystack_, yylen);
+        YYLLOC_DEFAULT (yylhs.location, range, yylen);
+        yyerror_range[1].location = yylhs.location;
+      }
+
+      // Perform the reduction.
+      YY_REDUCE_PRINT (yyn);
+#if YY_EXCEPTIONS
+      try
+#endif // YY_EXCEPTIONS
+        {
+          switch (yyn)
+            {
+  case 2: // axiom: program
+#line 144 "parser.yy"
+          { drv.end_program(yylhs.location); }
+#line 850 "parser.cc"
+    break;
+
+  case 3: // program: %empty
+#line 147 "parser.yy"
+         {}
+#line 856 "parser.cc"
+    break;
+
+  case 4: // program: program top ";"
+#line 148 "parser.yy"
+                    { drv.top_level(std::move(yystack_[1].value.as < std::unique_ptr<RootAST> > ()), yystack_[1].location + yystack_[0].location); }
+#line 862 "parser.cc"
+    break;
+
+  case 5: // top: %empty
+#line 151 "parser.yy"
+         { yylhs.value.as < std::unique_ptr<RootAST> > () = nullptr; }
+#line 868 "parser.cc"
+    break;
+
+  case 6: // top: fun_def
+#line 152 "parser.yy"
+            { yylhs.value.as < std::unique_ptr<RootAST> > () = std::move(yystack_[0].value.as < std::unique_ptr<FunctionAST> > ()); }
+#line 874 "parser.cc"
+    break;
+
+  case 7: // top: fun_ext
+#line 153 "parser.yy"
+            { yylhs.value.as < std::unique_ptr<RootAST> > () = std::move(yystack_[0].value.as < std::unique_ptr<FunctionPrototypeAST> > ()); }
+#line 880 "parser.cc"
+    break;
+
+  case 8: // top: expr
+#line 154 "parser.yy"
+         { yylhs.value.as < std::unique_ptr<RootAST> > () = std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()); }
+#line 886 "parser.cc"
+    break;
+
+  case 9: // fun_def: "def" fun_proto expr
+#line 157 "parser.yy"
+                       { yylhs.value.as < std::unique_ptr<FunctionAST> > () = std::make_unique<FunctionAST>(std::move(yystack_[1].value.as < std::unique_ptr<FunctionPrototypeAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 892 "parser.cc"
+    break;
+
+  case 10: // fun_proto: "id" "(" fun_proto_params ")"
+#line 160 "parser.yy"
+                                { yylhs.value.as < std::unique_ptr<FunctionPrototypeAST> > () = makePrototype(yystack_[3].value.as < std::string > (), yystack_[1].value.as < std::vector<std::pair<std::string, bool>> > (), yylhs.location); }
+#line 898 "parser.cc"
+    break;
+
+  case 11: // fun_proto_params: %empty
+#line 163 "parser.yy"
+         { yylhs.value.as < std::vector<std::pair<std::string, bool>> > () = std::vector<std::pair<std::string, bool>>(); }
+#line 904 "parser.cc"
+    break;
+
+  case 12: // fun_proto_params: "id" fun_proto_params
+#line 164 "parser.yy"
+                          { yystack_[0].value.as < std::vector<std::pair<std::string, bool>> > ().insert(yystack_[0].value.as < std::vector<std::pair<std::string, bool>> > ().begin(), std::make_pair(std::move(yystack_[1].value.as < std::string > ()), false)); yylhs.value.as < std::vector<std::pair<std::string, bool>> > () = std::move(yystack_[0].value.as < std::vector<std::pair<std::string, bool>> > ()); }
+#line 910 "parser.cc"
+    break;
+
+  case 13: // fun_proto_params: "id" "[" "]" fun_proto_params
+#line 165 "parser.yy"
+                                  { yystack_[0].value.as < std::vector<std::pair<std::string, bool>> > ().insert(yystack_[0].value.as < std::vector<std::pair<std::string, bool>> > ().begin(), std::make_pair(std::move(yystack_[3].value.as < std::string > ()), true)); yylhs.value.as < std::vector<std::pair<std::string, bool>> > () = std::move(yystack_[0].value.as < std::vector<std::pair<std::string, bool>> > ()); }
+#line 916 "parser.cc"
+    break;
+
+  case 14: // fun_ext: "extern" fun_proto
+#line 168 "parser.yy"
+                     { yylhs.value.as < std::unique_ptr<FunctionPrototypeAST> > () = std::move(yystack_[0].value.as < std::unique_ptr<FunctionPrototypeAST> > ()); }
+#line 922 "parser.cc"
+    break;
+
+  case 15: // expr: "number"
+#line 181 "parser.yy"
+           { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<NumberExprAST>(yystack_[0].value.as < double > (), yystack_[0].location); }
+#line 928 "parser.cc"
+    break;
+
+  case 16: // expr: expr "+" expr
+#line 182 "parser.yy"
+                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Add, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 934 "parser.cc"
+    break;
+
+  case 17: // expr: expr "-" expr
+#line 183 "parser.yy"
+                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Sub, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 940 "parser.cc"
+    break;
+
+  case 18: // expr: expr "*" expr
+#line 184 "parser.yy"
+                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Mul, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 946 "parser.cc"
+    break;
+
+  case 19: // expr: expr "/" expr
+#line 185 "parser.yy"
+                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Div, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 952 "parser.cc"
+    break;
+
+  case 20: // expr: expr "<" expr
+#line 186 "parser.yy"
+                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Lt, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 958 "parser.cc"
+    break;
+
+  case 21: // expr: expr "<=" expr
+#line 187 "parser.yy"
+                   { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Lte, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 964 "parser.cc"
+    break;
+
+  case 22: // expr: expr ">" expr
+#line 188 "parser.yy"
+                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Gt, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 970 "parser.cc"
+    break;
+
+  case 23: // expr: expr ">=" expr
+#line 189 "parser.yy"
+                   { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Gte, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 976 "parser.cc"
+    break;
+
+  case 24: // expr: expr "==" expr
+#line 190 "parser.yy"
+                   { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Eq, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 982 "parser.cc"
+    break;
+
+  case 25: // expr: expr "!=" expr
+#line 191 "parser.yy"
+                   { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Neq, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 988 "parser.cc"
+    break;
+
+  case 26: // expr: expr "and" expr
+#line 192 "parser.yy"
+                    { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::And, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 994 "parser.cc"
+    break;
+
+  case 27: // expr: expr "or" expr
+#line 193 "parser.yy"
+                   { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<BinaryExprAST>(BinaryOperator::Or, std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1000 "parser.cc"
+    break;
+
+  case 28: // expr: "not" expr
+#line 194 "parser.yy"
+               { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<UnaryExprAST>(UnaryOperator::LogicalNot, std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1006 "parser.cc"
+    break;
+
+  case 29: // expr: "id" "=" expr
+#line 195 "parser.yy"
+                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<AssignmentExprAST>(yystack_[2].value.as < std::string > (), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1012 "parser.cc"
+    break;
+
+  case 30: // expr: "id" "[" expr "]" "=" expr
+#line 196 "parser.yy"
+                               { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<ArrayAssignExprAST>(yystack_[5].value.as < std::string > (), std::move(yystack_[3].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1018 "parser.cc"
+    break;
+
+  case 31: // expr: expr ":" expr
+#line 197 "parser.yy"
+                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<CompositeExprAST>(std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1024 "parser.cc"
+    break;
+
+  case 32: // expr: "-" expr
+#line 198 "parser.yy"
+                          { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<UnaryExprAST>(UnaryOperator::NumericNeg, std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1030 "parser.cc"
+    break;
+
+  case 33: // expr: identifier_expr
+#line 199 "parser.yy"
+                    { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()); }
+#line 1036 "parser.cc"
+    break;
+
+  case 34: // expr: "(" expr ")"
+#line 200 "parser.yy"
+                 { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::move(yystack_[1].value.as < std::unique_ptr<ExprAST> > ()); }
+#line 1042 "parser.cc"
+    break;
+
+  case 35: // expr: "if" expr "then" expr "else" expr "end"
+#line 201 "parser.yy"
+                                            { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<IfExprAST>(std::move(yystack_[5].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[3].value.as < std::unique_ptr<ExprAST> > ()), std::move(yystack_[1].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1048 "parser.cc"
+    break;
+
+  case 36: // expr: "for" "id" "=" expr "," expr for_step "in" loop_pragmas expr "end"
+#line 203 "parser.yy"
+      {
+        yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<ForExprAST>(
+          std::make_unique<AssignmentExprAST>(yystack_[9].value.as < std::string > (), std::move(yystack_[7].value.as < std::unique_ptr<ExprAST> > ()), yystack_[7].location),
+          std::move(yystack_[5].value.as < std::unique_ptr<ExprAST> > ()), 
+          std::make_unique<AssignmentExprAST>(
+            yystack_[9].value.as < std::string > (),
+            std::make_unique<BinaryExprAST>(
+              BinaryOperator::Add,
+              std::make_unique<VariableExprAST>(yystack_[9].value.as < std::string > (), yystack_[9].location),
+              std::move(yystack_[4].value.as < std::unique_ptr<ExprAST> > ()),
+              yystack_[4].location
+            ),
+            yystack_[4].location
+          ),
+          yystack_[2].value.as < LoopPragmas > (),
+          std::move(yystack_[1].value.as < std::unique_ptr<ExprAST> > ()),
+          yylhs.location
+        );
+      }
+#line 1072 "parser.cc"
+    break;
+
+  case 37: // expr: "while" expr "in" loop_pragmas expr "end"
+#line 222 "parser.yy"
+                                              { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<WhileExprAST>(std::move(yystack_[4].value.as < std::unique_ptr<ExprAST> > ()), yystack_[2].value.as < LoopPragmas > (), std::move(yystack_[1].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1078 "parser.cc"
+    break;
+
+  case 38: // expr: "var" varlist "in" expr "end"
+#line 223 "parser.yy"
+                                  { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<VarExprAST>(std::move(yystack_[3].value.as < std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > ()), std::move(yystack_[1].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1084 "parser.cc"
+    break;
+
+  case 39: // varlist: varlist_var
+#line 226 "parser.yy"
+              { std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> v; v.push_back(std::move(yystack_[0].value.as < std::pair<std::string, std::unique_ptr<ExprAST>> > ())); yylhs.value.as < std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > () = std::move(v); }
+#line 1090 "parser.cc"
+    break;
+
+  case 40: // varlist: varlist_var "," varlist
+#line 227 "parser.yy"
+                            { yystack_[0].value.as < std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > ().insert(yystack_[0].value.as < std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > ().begin(), std::move(yystack_[2].value.as < std::pair<std::string, std::unique_ptr<ExprAST>> > ())); yylhs.value.as < std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > () = std::move(yystack_[0].value.as < std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>> > ()); }
+#line 1096 "parser.cc"
+    break;
+
+  case 41: // varlist_var: "id"
+#line 230 "parser.yy"
+       { yylhs.value.as < std::pair<std::string, std::unique_ptr<ExprAST>> > () = std::make_pair(yystack_[0].value.as < std::string > (), std::make_unique<NumberExprAST>(0, yylhs.location)); }
+#line 1102 "parser.cc"
+    break;
+
+  case 42: // varlist_var: "id" "=" expr
+#line 231 "parser.yy"
+                  { yylhs.value.as < std::pair<std::string, std::unique_ptr<ExprAST>> > () = std::make_pair(yystack_[2].value.as < std::string > (), std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ())); }
+#line 1108 "parser.cc"
+    break;
+
+  case 43: // varlist_var: "id" "[" "number" "]"
+#line 233 "parser.yy"
+      {
+        if (!(yystack_[1].value.as < double > () >= 1 && yystack_[1].value.as < double > () <= UINT32_MAX) || yystack_[1].value.as < double > () != (uint32_t) yystack_[1].value.as < double > ())
+          throw yy::parser::syntax_error(yystack_[1].location, "Array size must be a positive integer below 2^32");
+        yylhs.value.as < std::pair<std::string, std::unique_ptr<ExprAST>> > () = std::make_pair(yystack_[3].value.as < std::string > (), std::make_unique<NewArrayExprAST>((uint32_t) yystack_[1].value.as < double > (), yylhs.location));
+      }
+#line 1118 "parser.cc"
+    break;
+
+  case 44: // loop_pragmas: %empty
+#line 240 "parser.yy"
+         { yylhs.value.as < LoopPragmas > () = LoopPragmas(); }
+#line 1124 "parser.cc"
+    break;
+
+  case 45: // loop_pragmas: loop_pragmas "pragma"
+#line 241 "parser.yy"
+                          { applyLoopPragma(yystack_[1].value.as < LoopPragmas > (), yystack_[0].value.as < std::string > (), nullptr, yystack_[0].location); yylhs.value.as < LoopPragmas > () = yystack_[1].value.as < LoopPragmas > (); }
+#line 1130 "parser.cc"
+    break;
+
+  case 46: // loop_pragmas: loop_pragmas "pragma(" "number" ")"
+#line 242 "parser.yy"
+                                        { applyLoopPragma(yystack_[3].value.as < LoopPragmas > (), yystack_[2].value.as < std::string > (), &yystack_[1].value.as < double > (), yystack_[2].location + yystack_[0].location); yylhs.value.as < LoopPragmas > () = yystack_[3].value.as < LoopPragmas > (); }
+#line 1136 "parser.cc"
+    break;
+
+  case 47: // for_step: %empty
+#line 245 "parser.yy"
+         { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<NumberExprAST>(1.0, yylhs.location); }
+#line 1142 "parser.cc"
+    break;
+
+  case 48: // for_step: "," expr
+#line 246 "parser.yy"
+             { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ()); }
+#line 1148 "parser.cc"
+    break;
+
+  case 49: // identifier_expr: "id"
+#line 249 "parser.yy"
+       { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<VariableExprAST>(std::move(yystack_[0].value.as < std::string > ()), yylhs.location); }
+#line 1154 "parser.cc"
+    break;
+
+  case 50: // identifier_expr: "id" "(" opt_expr_list ")"
+#line 250 "parser.yy"
+                               { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<CallExprAST>(std::move(yystack_[3].value.as < std::string > ()), std::move(yystack_[1].value.as < std::vector<std::unique_ptr<ExprAST>> > ()), yylhs.location); }
+#line 1160 "parser.cc"
+    break;
+
+  case 51: // identifier_expr: "id" "[" expr "]"
+#line 251 "parser.yy"
+                      { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<ArrayIndexExprAST>(std::move(yystack_[3].value.as < std::string > ()), std::move(yystack_[1].value.as < std::unique_ptr<ExprAST> > ()), yylhs.location); }
+#line 1166 "parser.cc"
+    break;
+
+  case 52: // identifier_expr: "len" "(" "id" ")"
+#line 252 "parser.yy"
+                       { yylhs.value.as < std::unique_ptr<ExprAST> > () = std::make_unique<ArrayLengthExprAST>(std::move(yystack_[1].value.as < std::string > ()), yylhs.location); }
+#line 1172 "parser.cc"
+    break;
+
+  case 53: // opt_expr_list: %empty
+#line 255 "parser.yy"
+         { yylhs.value.as < std::vector<std::unique_ptr<ExprAST>> > () = std::vector<std::unique_ptr<ExprAST>>(); }
+#line 1178 "parser.cc"
+    break;
+
+  case 54: // opt_expr_list: expr_list
+#line 256 "parser.yy"
+              { yylhs.value.as < std::vector<std::unique_ptr<ExprAST>> > () = std::move(yystack_[0].value.as < std::vector<std::unique_ptr<ExprAST>> > ()); }
+#line 1184 "parser.cc"
+    break;
+
+  case 55: // expr_list: expr
+#line 259 "parser.yy"
+        { auto v = std::vector<std::unique_ptr<ExprAST>>(); v.push_back(std::move(yystack_[0].value.as < std::unique_ptr<ExprAST> > ())); yylhs.value.as < std::vector<std::unique_ptr<ExprAST>> > () = std::move(v); }
+#line 1190 "parser.cc"
+    break;
+
+  case 56: // expr_list: expr "," expr_list
+#line 260 "parser.yy"
+                       { yystack_[0].value.as < std::vector<std::unique_ptr<ExprAST>> > ().insert(yystack_[0].value.as < std::vector<std::unique_ptr<ExprAST>> > ().begin(), std::move(yystack_[2].value.as < std::unique_ptr<ExprAST> > ())); yylhs.value.as < std::vector<std::unique_ptr<ExprAST>> > () = std::move(yystack_[0].value.as < std::vector<std::unique_ptr<ExprAST>> > ());  }
+#line 1196 "parser.cc"
+    break;
+
+
+#line 1200 "parser.cc"
+
+            default:
+              break;
+            }
+        }
+#if YY_EXCEPTIONS
+      catch (const syntax_error& yyexc)
+        {
+          YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+          error (yyexc);
+          YYERROR;
+        }
+#endif // YY_EXCEPTIONS
+      YY_SYMBOL_PRINT ("-> $$ =", yylhs);
+      yypop_ (yylen);
+      yylen = 0;
+
+      // Shift the result of the reduction.
+      yypush_ (YY_NULLPTR, YY_MOVE (yylhs));
+    }
+    goto yynewstate;
+
+
+  /*--------------------------------------.
+  | yyerrlab -- here on detecting error.  |
+  `--------------------------------------*/
+  yyerrlab:
+    // If not already recovering from an error, report this error.
+    if (!yyerrstatus_)
+      {
+        ++yynerrs_;
+        context yyctx (*this, yyla);
+        std::string msg = yysyntax_error_ (yyctx);
+        error (yyla.location, YY_MOVE (msg));
+      }
+
+
+    yyerror_range[1].location = yyla.location;
+    if (yyerrstatus_ == 3)
+      {
+        /* If just tried and failed to reuse lookahead token after an
+           error, discard it.  */
+
+        // Return failure if at end of input.
+        if (yyla.kind () == symbol_kind::S_YYEOF)
+          YYABORT;
+        else if (!yyla.empty ())
+          {
+            yy_destroy_ ("Error: discarding", yyla);
+            yyla.clear ();
+          }
+      }
+
+    // Else will try to reuse lookahead token after shifting the error token.
+    goto yyerrlab1;
+
+
+  /*---------------------------------------------------.
+  | yyerrorlab -- error raised explicitly by YYERROR.  |
+  `---------------------------------------------------*/
+  yyerrorlab:
+    /* Pacify compilers when the user code never invokes YYERROR and
+       the label yyerrorlab therefore never appears in user code.  */
+    if (false)
+      YYERROR;
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYERROR.  */
+    yypop_ (yylen);
+    yylen = 0;
+    YY_STACK_PRINT ();
+    goto yyerrlab1;
+
+
+  /*-------------------------------------------------------------.
+  | yyerrlab1 -- common code for both syntax error and YYERROR.  |
+  `-------------------------------------------------------------*/
+  yyerrlab1:
+    yyerrstatus_ = 3;   // Each real token shifted decrements this.
+    // Pop stack until we find a state that shifts the error token.
+    for (;;)
+      {
+        yyn = yypact_[+yystack_[0].state];
+        if (!yy_pact_value_is_default_ (yyn))
+          {
+            yyn += symbol_kind::S_YYerror;
+            if (0 <= yyn && yyn <= yylast_
+                && yycheck_[yyn] == symbol_kind::S_YYerror)
+              {
+                yyn = yytable_[yyn];
+                if (0 < yyn)
+                  break;
+              }
+          }
+
+        // Pop the current state because it cannot handle the error token.
+        if (yystack_.size () == 1)
+          YYABORT;
+
+        yyerror_range[1].location = yystack_[0].location;
+        yy_destroy_ ("Error: popping", yystack_[0]);
+        yypop_ ();
+        YY_STACK_PRINT ();
+      }
+    {
+      stack_symbol_type error_token;
+
+      yyerror_range[2].location = yyla.location;
+      YYLLOC_DEFAULT (error_token.location, yyerror_range, 2);
+
+      // Shift the error token.
+      yy_lac_discard_ ("error recovery");
+      error_token.state = state_type (yyn);
+      yypush_ ("Shifting", YY_MOVE (error_token));
+    }
+    goto yynewstate;
+
+
+  /*-------------------------------------.
+  | yyacceptlab -- YYACCEPT comes here.  |
+  `-------------------------------------*/
+  yyacceptlab:
+    yyresult = 0;
+    goto yyreturn;
+
+
+  /*-----------------------------------.
+  | yyabortlab -- YYABORT comes here.  |
+  `-----------------------------------*/
+  yyabortlab:
+    yyresult = 1;
+    goto yyreturn;
+
+
+  /*-----------------------------------------------------.
+  | yyreturn -- parsing is finished, return the result.  |
+  `-----------------------------------------------------*/
+  yyreturn:
+    if (!yyla.empty ())
+      yy_destroy_ ("Cleanup: discarding lookahead", yyla);
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYABORT or YYACCEPT.  */
+    yypop_ (yylen);
+    YY_STACK_PRINT ();
+    while (1 < yystack_.size ())
+      {
+        yy_destroy_ ("Cleanup: popping", yystack_[0]);
+        yypop_ ();
+      }
+
+    return yyresult;
+  }
+#if YY_EXCEPTIONS
+    catch (...)
+      {
+        YYCDEBUG << "Exception caught: cleaning lookahead and stack\n";
+        // Do not try to display the values of the reclaimed symbols,
+        // as their printers might throw an exception.
+        if (!yyla.empty ())
+          yy_destroy_ (YY_NULLPTR, yyla);
+
+        while (1 < yystack_.size ())
+          {
+            yy_destroy_ (YY_NULLPTR, yystack_[0]);
+            yypop_ ();
+          }
+        throw;
+      }
+#endif // YY_EXCEPTIONS
+  }
+
+  void
+  parser::error (const syntax_error& yyexc)
+  {
+    error (yyexc.location, yyexc.what ());
+  }
+
+  const char *
+  parser::symbol_name (symbol_kind_type yysymbol)
+  {
+    static const char *const yy_sname[] =
+    {
+    "end of file", "error", "invalid token", ";", ":", ",", "-", "+", "*",
+  "/", "(", ")", "[", "]", "<", "<=", ">", ">=", "==", "!=", "=", "for",
+  "while", "in", "extern", "def", "if", "then", "else", "end", "var",
+  "and", "or", "not", "len", "id", "number", "pragma", "pragma(", "UMINUS",
+  "$accept", "axiom", "program", "top", "fun_def", "fun_proto",
+  "fun_proto_params", "fun_ext", "expr", "varlist", "varlist_var",
+  "loop_pragmas", "for_step", "identifier_expr", "opt_expr_list",
+  "expr_list", YY_NULLPTR
+    };
+    return yy_sname[yysymbol];
+  }
+
+
+
+  // parser::context.
+  parser::context::context (const parser& yyparser, const symbol_type& yyla)
+    : yyparser_ (yyparser)
+    , yyla_ (yyla)
+  {}
+
+  int
+  parser::context::expected_tokens (symbol_kind_type yyarg[], int yyargn) const
+  {
+    // Actual number of expected tokens
+    int yycount = 0;
+
+#if YYDEBUG
+    // Execute LAC once. We don't care if it is successful, we
+    // only do it for the sake of debugging output.
+    if (!yyparser_.yy_lac_established_)
+      yyparser_.yy_lac_check_ (yyla_.kind ());
+#endif
+
+    for (int yyx = 0; yyx < YYNTOKENS; ++yyx)
+      {
+        symbol_kind_type yysym = YY_CAST (symbol_kind_type, yyx);
+        if (yysym != symbol_kind::S_YYerror
+            && yysym != symbol_kind::S_YYUNDEF
+            && yyparser_.yy_lac_check_ (yysym))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = yysym;
+          }
+      }
+    if (yyarg && yycount == 0 && 0 < yyargn)
+      yyarg[0] = symbol_kind::S_YYEMPTY;
+    return yycount;
+  }
+
+
+
+
+  bool
+  parser::yy_lac_check_ (symbol_kind_type yytoken) const
+  {
+    // Logically, the yylac_stack's lifetime is confined to this function.
+    // Clear it, to get rid of potential left-overs from previous call.
+    yylac_stack_.clear ();
+    // Reduce until we encounter a shift and thereby accept the token.
+#if YYDEBUG
+    YYCDEBUG << "LAC: checking lookahead " << symbol_name (yytoken) << ':';
+#endif
+    std::ptrdiff_t lac_top = 0;
+    while (true)
+      {
+        state_type top_state = (yylac_stack_.empty ()
+                                ? yystack_[lac_top].state
+                                : yylac_stack_.back ());
+        int yyrule = yypact_[+top_state];
+        if (yy_pact_value_is_default_ (yyrule)
+            || (yyrule += yytoken) < 0 || yylast_ < yyrule
+            || yycheck_[yyrule] != yytoken)
+          {
+            // Use the default action.
+            yyrule = yydefact_[+top_state];
+            if (yyrule == 0)
+              {
+                YYCDEBUG << " Err\n";
+                return false;
+              }
+          }
+        else
+          {
+            // Use the action from yytable.
+            yyrule = yytable_[yyrule];
+            if (yy_table_value_is_error_ (yyrule))
+              {
+                YYCDEBUG << " Err\n";
+                return false;
+              }
+            if (0 < yyrule)
+              {
+                YYCDEBUG << " S" << yyrule << '\n';
+                return true;
+              }
+            yyrule = -yyrule;
+          }
+        // By now we know we have to simulate a reduce.
+        YYCDEBUG << " R" << yyrule - 1;
+        // Pop the corresponding number of values from the stack.
+        {
+          std::ptrdiff_t yylen = yyr2_[yyrule];
+          // First pop from the LAC stack as many tokens as possible.
+          std::ptrdiff_t lac_size = std::ptrdiff_t (yylac_stack_.size ());
+          if (yylen < lac_size)
+            {
+              yylac_stack_.resize (std::size_t (lac_size - yylen));
+              yylen = 0;
+            }
+          else if (lac_size)
+            {
+              yylac_stack_.clear ();
+              yylen -= lac_size;
+            }
+          // Only afterwards look at the main stack.
+          // We simulate popping elements by incrementing lac_top.
+          lac_top += yylen;
+        }
+        // Keep top_state in sync with the updated stack.
+        top_state = (yylac_stack_.empty ()
+                     ? yystack_[lac_top].state
+                     : yylac_stack_.back ());
+        // Push the resulting state of the reduction.
+        state_type state = yy_lr_goto_state_ (top_state, yyr1_[yyrule]);
+        YYCDEBUG << " G" << int (state);
+        yylac_stack_.push_back (state);
+      }
+  }
+
+  // Establish the initial context if no initial context currently exists.
+  bool
+  parser::yy_lac_establish_ (symbol_kind_type yytoken)
+  {
+    /* Establish the initial context for the current lookahead if no initial
+       context is currently established.
+
+       We define a context as a snapshot of the parser stacks.  We define
+       the initial context for a lookahead as the context in which the
+       parser initially examines that lookahead in order to select a
+       syntactic action.  Thus, if the lookahead eventually proves
+       syntactically unacceptable (possibly in a later context reached via a
+       series of reductions), the initial context can be used to determine
+       the exact set of tokens that would be syntactically acceptable in the
+       lookahead's place.  Moreover, it is the context after which any
+       further semantic actions would be erroneous because they would be
+       determined by a syntactically unacceptable token.
+
+       yy_lac_establish_ should be invoked when a reduction is about to be
+       performed in an inconsistent state (which, for the purposes of LAC,
+       includes consistent states that don't know they're consistent because
+       their default reductions have been disabled).
+
+       For parse.lac=full, the implementation of yy_lac_establish_ is as
+       follows.  If no initial context is currently established for the
+       current lookahead, then check if that lookahead can eventually be
+       shifted if syntactic actions continue from the current context.  */
+    if (yy_lac_established_)
+      return true;
+    else
+      {
+#if YYDEBUG
+        YYCDEBUG << "LAC: initial context established for "
+                 << symbol_name (yytoken) << '\n';
+#endif
+        yy_lac_established_ = true;
+        return yy_lac_check_ (yytoken);
+      }
+  }
+
+  // Discard any previous initial lookahead context.
+  void
+  parser::yy_lac_discard_ (const char* event)
+  {
+   /* Discard any previous initial lookahead context because of Event,
+      which may be a lookahead change or an invalidation of the currently
+      established initial context for the current lookahead.
+
+      The most common example of a lookahead change is a shift.  An example
+      of both cases is syntax error recovery.  That is, a syntax error
+      occurs when the lookahead is syntactically erroneous for the
+      currently established initial context, so error recovery manipulates
+      the parser stacks to try to find a new initial context in which the
+      current lookahead is syntactically acceptable.  If it fails to find
+      such a context, it discards the lookahead.  */
+    if (yy_lac_established_)
+      {
+        YYCDEBUG << "LAC: initial context discarded due to "
+                 << event << '\n';
+        yy_lac_established_ = false;
+      }
+  }
+
+
+  int
+  parser::yy_syntax_error_arguments_ (const context& yyctx,
+                                                 symbol_kind_type yyarg[], int yyargn) const
+  {
+    /* There are many possibilities here to consider:
+       - If this state is a consistent state with a default action, then
+         the only way this function was invoked is if the default action
+         is an error action.  In that case, don't check for expected
+         tokens because there are none.
+       - The only way there can be no lookahead present (in yyla) is
+         if this state is a consistent state with a default action.
+         Thus, detecting the absence of a lookahead is sufficient to
+         determine that there is no unexpected or expected token to
+         report.  In that case, just report a simple "syntax error".
+       - Don't assume there isn't a lookahead just because this state is
+         a consistent state with a default action.  There might have
+         been a previous inconsistent state, consistent state with a
+         non-default action, or user semantic action that manipulated
+         yyla.  (However, yyla is currently not documented for users.)
+         In the first two cases, it might appear that the current syntax
+         error should have been detected in the previous state when
+         yy_lac_check was invoked.  However, at that time, there might
+         have been a different syntax error that discarded a different
+         initial context during error recovery, leaving behind the
+         current lookahead.
+    */
+
+    if (!yyctx.lookahead ().empty ())
+      {
+        if (yyarg)
+          yyarg[0] = yyctx.token ();
+        int yyn = yyctx.expected_tokens (yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+        return yyn + 1;
+      }
+    return 0;
+  }
+
+  // Generate an error message.
+  std::string
+  parser::yysyntax_error_ (const context& yyctx) const
+  {
+    // Its maximum.
+    enum { YYARGS_MAX = 5 };
+    // Arguments of yyformat.
+    symbol_kind_type yyarg[YYARGS_MAX];
+    int yycount = yy_syntax_error_arguments_ (yyctx, yyarg, YYARGS_MAX);
+
+    char const* yyformat = YY_NULLPTR;
+    switch (yycount)
+      {
+#define YYCASE_(N, S)                         \
+        case N:                               \
+          yyformat = S;                       \
+        break
+      default: // Avoid compiler warnings.
+        YYCASE_ (0, YY_("syntax error"));
+        YYCASE_ (1, YY_("syntax error, unexpected %s"));
+        YYCASE_ (2, YY_("syntax error, unexpected %s, expecting %s"));
+        YYCASE_ (3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+        YYCASE_ (4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+        YYCASE_ (5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+      }
+
+    std::string yyres;
+    // Argument number.
+    std::ptrdiff_t yyi = 0;
+    for (char const* yyp = yyformat; *yyp; ++yyp)
+      if (yyp[0] == '%' && yyp[1] == 's' && yyi < yycount)
+        {
+          yyres += symbol_name (yyarg[yyi++]);
+          ++yyp;
+        }
+      else
+        yyres += *yyp;
+    return yyres;
+  }
+
+
+  const signed char parser::yypact_ninf_ = -82;
+
+  const signed char parser::yytable_ninf_ = -6;
+
+  const short
+  parser::yypact_[] =
+  {
+     -82,     4,    52,   -82,   102,   102,    -7,   102,    -5,    -5,
+     102,    -4,   102,    22,    -3,   -82,    32,   -82,   -82,   385,
+     -82,   -82,   135,    29,   154,    41,   -82,   102,   174,     6,
+      30,    47,     5,    24,   102,   102,   102,   -82,   102,   102,
+     102,   102,   102,   102,   102,   102,   102,   102,   102,   102,
+     102,   -82,   102,   -82,    25,   385,   102,    27,   102,   102,
+      -4,    50,   203,    53,   -82,   223,   404,   385,     7,     7,
+     -82,   -82,   441,   441,   441,   441,   441,   441,     5,   423,
+     242,    84,    -6,    54,   261,    55,   385,   290,   -82,   -82,
+     102,   -82,    46,   102,   -82,    31,   309,    56,   -82,   -82,
+     102,   -82,   -82,   -82,   102,   328,    59,   -82,    25,   347,
+     404,   102,    48,   -82,   -82,   -82,   385,   -82,    84,   366,
+     -82
+  };
+
+  const signed char
+  parser::yydefact_[] =
+  {
+       3,     0,     2,     1,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    49,    15,     0,     6,     7,     8,
+      33,    32,     0,     0,     0,     0,    14,     0,     0,    41,
+       0,    39,    28,     0,    53,     0,     0,     4,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    34,     0,    44,    11,     9,     0,     0,     0,     0,
+       0,     0,    55,     0,    54,     0,    29,    31,    17,    16,
+      18,    19,    20,    21,    22,    23,    24,    25,    26,    27,
+       0,     0,    11,     0,     0,     0,    42,     0,    40,    52,
+       0,    50,    51,     0,    45,     0,     0,     0,    12,    10,
+       0,    43,    38,    56,     0,    47,     0,    37,    11,     0,
+      30,     0,     0,    46,    13,    35,    48,    44,     0,     0,
+      36
+  };
+
+  const signed char
+  parser::yypgoto_[] =
+  {
+     -82,   -82,   -82,   -82,   -82,    63,   -81,   -82,    -2,    15,
+     -82,   -37,   -82,   -82,   -82,    -9
+  };
+
+  const signed char
+  parser::yydefgoto_[] =
+  {
+       0,     1,     2,    16,    17,    26,    83,    18,    62,    30,
+      31,    81,   112,    20,    63,    64
+  };
+
+  const signed char
+  parser::yytable_[] =
+  {
+      19,    98,    21,    22,     3,    24,    97,    34,    28,    35,
+      32,    39,    40,    41,    42,    41,    42,    36,    57,    43,
+      44,    45,    46,    47,    48,    55,    58,   114,    23,    82,
+      25,    29,    33,    65,    66,    37,    67,    68,    69,    70,
+      71,    72,    73,    74,    75,    76,    77,    78,    79,    52,
+      80,    54,    60,    59,    84,    -5,    86,    87,     4,    61,
+      82,    89,     5,    85,    91,    99,   104,   106,   101,   108,
+     113,   117,    27,     6,     7,    88,     8,     9,    10,    96,
+     118,   103,    11,     0,     0,    12,    13,    14,    15,     0,
+       4,   105,     0,     0,     5,     0,     0,     0,   109,     0,
+       0,     0,   110,     0,     0,     6,     7,     0,     4,   116,
+      10,     0,     5,     0,    11,     0,   119,    12,    13,    14,
+      15,    94,    95,     6,     7,     0,     0,     0,    10,     0,
+       0,     0,    11,     0,     0,    12,    13,    14,    15,    38,
+       0,    39,    40,    41,    42,     0,    51,     0,     0,    43,
+      44,    45,    46,    47,    48,     0,     0,     0,    38,     0,
+      39,    40,    41,    42,     0,     0,    49,    50,    43,    44,
+      45,    46,    47,    48,     0,     0,     0,    53,    38,     0,
+      39,    40,    41,    42,     0,    49,    50,     0,    43,    44,
+      45,    46,    47,    48,     0,     0,     0,     0,     0,     0,
+       0,    56,     0,     0,     0,    49,    50,    38,    90,    39,
+      40,    41,    42,     0,     0,     0,     0,    43,    44,    45,
+      46,    47,    48,     0,     0,     0,     0,    38,     0,    39,
+      40,    41,    42,     0,    49,    50,    92,    43,    44,    45,
+      46,    47,    48,     0,     0,     0,    38,    93,    39,    40,
+      41,    42,     0,     0,    49,    50,    43,    44,    45,    46,
+      47,    48,     0,     0,     0,    38,     0,    39,    40,    41,
+      42,     0,     0,    49,    50,    43,    44,    45,    46,    47,
+      48,     0,     0,     0,     0,     0,     0,     0,     0,   100,
+       0,     0,    49,    50,    38,     0,    39,    40,    41,    42,
+       0,     0,     0,     0,    43,    44,    45,    46,    47,    48,
+       0,     0,     0,    38,     0,    39,    40,    41,    42,   102,
+       0,    49,    50,    43,    44,    45,    46,    47,    48,     0,
+       0,     0,    38,   111,    39,    40,    41,    42,   107,     0,
+      49,    50,    43,    44,    45,    46,    47,    48,     0,     0,
+       0,    38,     0,    39,    40,    41,    42,     0,     0,    49,
+      50,    43,    44,    45,    46,    47,    48,     0,     0,     0,
+      38,     0,    39,    40,    41,    42,   115,     0,    49,    50,
+      43,    44,    45,    46,    47,    48,     0,     0,     0,    38,
+       0,    39,    40,    41,    42,   120,     0,    49,    50,    43,
+      44,    45,    46,    47,    48,     0,     0,     0,     0,     0,
+      39,    40,    41,    42,     0,     0,    49,    50,    43,    44,
+      45,    46,    47,    48,     0,     0,     0,     0,     0,    39,
+      40,    41,    42,     0,     0,    49,    50,    43,    44,    45,
+      46,    47,    48,     0,     0,     0,     0,    39,    40,    41,
+      42,     0,     0,     0,    49,    -6,    -6,    -6,    -6,    -6,
+      -6
+  };
+
+  const signed char
+  parser::yycheck_[] =
+  {
+       2,    82,     4,     5,     0,     7,    12,    10,    10,    12,
+      12,     6,     7,     8,     9,     8,     9,    20,    12,    14,
+      15,    16,    17,    18,    19,    27,    20,   108,    35,    35,
+      35,    35,    10,    35,    36,     3,    38,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    20,
+      52,    10,     5,    23,    56,     3,    58,    59,     6,    35,
+      35,    11,    10,    36,    11,    11,    20,    36,    13,    13,
+      11,    23,     9,    21,    22,    60,    24,    25,    26,    81,
+     117,    90,    30,    -1,    -1,    33,    34,    35,    36,    -1,
+       6,    93,    -1,    -1,    10,    -1,    -1,    -1,   100,    -1,
+      -1,    -1,   104,    -1,    -1,    21,    22,    -1,     6,   111,
+      26,    -1,    10,    -1,    30,    -1,   118,    33,    34,    35,
+      36,    37,    38,    21,    22,    -1,    -1,    -1,    26,    -1,
+      -1,    -1,    30,    -1,    -1,    33,    34,    35,    36,     4,
+      -1,     6,     7,     8,     9,    -1,    11,    -1,    -1,    14,
+      15,    16,    17,    18,    19,    -1,    -1,    -1,     4,    -1,
+       6,     7,     8,     9,    -1,    -1,    31,    32,    14,    15,
+      16,    17,    18,    19,    -1,    -1,    -1,    23,     4,    -1,
+       6,     7,     8,     9,    -1,    31,    32,    -1,    14,    15,
+      16,    17,    18,    19,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    27,    -1,    -1,    -1,    31,    32,     4,     5,     6,
+       7,     8,     9,    -1,    -1,    -1,    -1,    14,    15,    16,
+      17,    18,    19,    -1,    -1,    -1,    -1,     4,    -1,     6,
+       7,     8,     9,    -1,    31,    32,    13,    14,    15,    16,
+      17,    18,    19,    -1,    -1,    -1,     4,     5,     6,     7,
+       8,     9,    -1,    -1,    31,    32,    14,    15,    16,    17,
+      18,    19,    -1,    -1,    -1,     4,    -1,     6,     7,     8,
+       9,    -1,    -1,    31,    32,    14,    15,    16,    17,    18,
+      19,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    28,
+      -1,    -1,    31,    32,     4,    -1,     6,     7,     8,     9,
+      -1,    -1,    -1,    -1,    14,    15,    16,    17,    18,    19,
+      -1,    -1,    -1,     4,    -1,     6,     7,     8,     9,    29,
+      -1,    31,    32,    14,    15,    16,    17,    18,    19,    -1,
+      -1,    -1,     4,     5,     6,     7,     8,     9,    29,    -1,
+      31,    32,    14,    15,    16,    17,    18,    19,    -1,    -1,
+      -1,     4,    -1,     6,     7,     8,     9,    -1,    -1,    31,
+      32,    14,    15,    16,    17,    18,    19,    -1,    -1,    -1,
+       4,    -1,     6,     7,     8,     9,    29,    -1,    31,    32,
+      14,    15,    16,    17,    18,    19,    -1,    -1,    -1,     4,
+      -1,     6,     7,     8,     9,    29,    -1,    31,    32,    14,
+      15,    16,    17,    18,    19,    -1,    -1,    -1,    -1,    -1,
+       6,     7,     8,     9,    -1,    -1,    31,    32,    14,    15,
+      16,    17,    18,    19,    -1,    -1,    -1,    -1,    -1,     6,
+       7,     8,     9,    -1,    -1,    31,    32,    14,    15,    16,
+      17,    18,    19,    -1,    -1,    -1,    -1,     6,     7,     8,
+       9,    -1,    -1,    -1,    31,    14,    15,    16,    17,    18,
+      19
+  };
+
+  const signed char
+  parser::yystos_[] =
+  {
+       0,    41,    42,     0,     6,    10,    21,    22,    24,    25,
+      26,    30,    33,    34,    35,    36,    43,    44,    47,    48,
+      53,    48,    48,    35,    48,    35,    45,    45,    48,    35,
+      49,    50,    48,    10,    10,    12,    20,     3,     4,     6,
+       7,     8,     9,    14,    15,    16,    17,    18,    19,    31,
+      32,    11,    20,    23,    10,    48,    27,    12,    20,    23,
+       5,    35,    48,    54,    55,    48,    48,    48,    48,    48,
+      48,    48,    48,    48,    48,    48,    48,    48,    48,    48,
+      48,    51,    35,    46,    48,    36,    48,    48,    49,    11,
+       5,    11,    13,     5,    37,    38,    48,    12,    46,    11,
+      28,    13,    29,    55,    20,    48,    36,    29,    13,    48,
+      48,     5,    52,    11,    46,    29,    48,    23,    51,    48,
+      29
+  };
+
+  const signed char
+  parser::yyr1_[] =
+  {
+       0,    40,    41,    42,    42,    43,    43,    43,    43,    44,
+      45,    46,    46,    46,    47,    48,    48,    48,    48,    48,
+      48,    48,    48,    48,    48,    48,    48,    48,    48,    48,
+      48,    48,    48,    48,    48,    48,    48,    48,    48,    49,
+      49,    50,    50,    50,    51,    51,    51,    52,    52,    53,
+      53,    53,    53,    54,    54,    55,    55
+  };
+
+  const signed char
+  parser::yyr2_[] =
+  {
+       0,     2,     1,     0,     3,     0,     1,     1,     1,     3,
+       4,     0,     2,     4,     2,     1,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     2,     3,
+       6,     3,     2,     1,     3,     7,    11,     6,     5,     1,
+       3,     1,     3,     4,     0,     2,     4,     0,     2,     1,
+       4,     4,     4,     0,     1,     1,     3
+  };
+
+
+
+
+#if YYDEBUG
+  const short
+  parser::yyrline_[] =
+  {
+       0,   144,   144,   147,   148,   151,   152,   153,   154,   157,
+     160,   163,   164,   165,   168,   181,   182,   183,   184,   185,
+     186,   187,   188,   189,   190,   191,   192,   193,   194,   195,
+     196,   197,   198,   199,   200,   201,   202,   222,   223,   226,
+     227,   230,   231,   232,   240,   241,   242,   245,   246,   249,
+     250,   251,   252,   255,   256,   259,   260
+  };
+
+  void
+  parser::yy_stack_print_ () const
+  {
+    *yycdebug_ << "Stack now";
+    for (stack_type::const_iterator
+           i = yystack_.begin (),
+           i_end = yystack_.end ();
+         i != i_end; ++i)
+      *yycdebug_ << ' ' << int (i->state);
+    *yycdebug_ << '\n';
+  }
+
+  void
+  parser::yy_reduce_print_ (int yyrule) const
+  {
+    int yylno = yyrline_[yyrule];
+    int yynrhs = yyr2_[yyrule];
+    // Print the symbols being reduced, and their result.
+    *yycdebug_ << "Reducing stack by rule " << yyrule - 1
+               << " (line " << yylno << "):\n";
+    // The symbols being reduced.
+    for (int yyi = 0; yyi < yynrhs; yyi++)
+      YY_SYMBOL_PRINT ("   $" << yyi + 1 << " =",
+                       yystack_[(yynrhs) - (yyi + 1)]);
+  }
+#endif // YYDEBUG
+
+
+} // yy
+#line 1902 "parser.cc"
+
+#line 263 "parser.yy"
+
+
+
+void yy::parser::error (const location_type& l, const std::string& m)
+{
+  drv.diagnostics.push_back(drv.describe(l) + ": " + m);
+}
@@ -12,13 +12,67 @@
 %param { driver& drv }
 
 %locations
+%define api.location.type {SourceRange}
 
 %define parse.trace
 %define parse.error detailed
 %define parse.lac full
 
 %code {
+  #include <algorithm>
+  #include <climits>
   #include "driver.hh"
+
+  // Merge the pragma "@name" or "@name(arg)" into pragmas, rejecting malformed or conflicting ones.
+  static void applyLoopPragma(LoopPragmas& pragmas, const std::string& name, const double* arg, const SourceRange& loc)
+  {
+    unsigned count = 0;
+    if (arg) {
+      if (!(*arg >= 1 && *arg <= UINT_MAX) || *arg != (unsigned) *arg)
+        throw yy::parser::syntax_error(loc, "Argument of @" + name + " must be a positive integer");
+      count = (unsigned) *arg;
+    }
+
+    if (name == "unroll" || name == "nounroll") {
+      if (pragmas.unroll || pragmas.unroll_disable)
+        throw yy::parser::syntax_error(loc, "Duplicate unroll pragma on loop");
+      if (name == "nounroll" && arg)
+        throw yy::parser::syntax_error(loc, "@nounroll takes no argument");
+
+      pragmas.unroll = name == "unroll";
+      pragmas.unroll_disable = name == "nounroll";
+      pragmas.unroll_count = count;
+    }
+    else if (name == "vectorize" || name == "novectorize") {
+      if (pragmas.vectorize || pragmas.vectorize_disable)
+        throw yy::parser::syntax_error(loc, "Duplicate vectorize pragma on loop");
+      if (name == "novectorize" && arg)
+        throw yy::parser::syntax_error(loc, "@novectorize takes no argument");
+      if (count & (count - 1))
+        throw yy::parser::syntax_error(loc, "Vectorization width must be a power of two");
+
+      pragmas.vectorize = name == "vectorize";
+      pragmas.vectorize_disable = name == "novectorize";
+      pragmas.vectorize_width = count;
+    }
+    else
+      throw yy::parser::syntax_error(loc, "Unknown loop pragma: @" + name);
+  }
+
+  // Build a prototype from its parameters, each paired with whether it is an array.
+  static std::unique_ptr<FunctionPrototypeAST> makePrototype(const std::string& name, const std::vector<std::pair<std::string, bool>>& params, const SourceRange& loc)
+  {
+    std::vector<std::string> names;
+    std::vector<bool> arrays;
+    for (auto& param : params) {
+      names.push_back(param.first);
+      arrays.push_back(param.second);
+    }
+
+    if (std::find(arrays.begin(), arrays.end(), true) == arrays.end())
+      arrays.clear();
+    return std::make_unique<FunctionPrototypeAST>(name, std::move(names), loc, std::move(arrays));
+  }
 }
 
 %define api.token.raw
@@ -35,6 +89,8 @@
  SLASH "/"
  LPAREN "("
  RPAREN ")"
+ LBRACKET "["
+ RBRACKET "]"
  LT "<"
  LTE "<="
  GT ">"
@@ -52,22 +108,28 @@
  ELSE "else"
  END "end"
  VAR "var"
+ AND "and"
+ OR "or"
+ NOT "not"
+ LEN "len"
 ;
 
 %token <std::string> IDENTIFIER "id"
 %token <double> NUMBER "number"
+%token <std::string> PRAGMA "pragma"
+%token <std::string> PRAGMA_ARGS "pragma("
 
-%nterm <std::unique_ptr<SequenceAST>> program
 %nterm <std::unique_ptr<RootAST>> top
 
 %nterm <std::unique_ptr<FunctionAST>> fun_def
 %nterm <std::unique_ptr<FunctionPrototypeAST>> fun_proto
-%nterm <std::vector<std::string>> fun_proto_params
+%nterm <std::vector<std::pair<std::string, bool>>> fun_proto_params
 %nterm <std::unique_ptr<FunctionPrototypeAST>> fun_ext
 
 %nterm <std::unique_ptr<ExprAST>> expr
 %nterm <std::unique_ptr<ExprAST>> identifier_expr
 %nterm <std::unique_ptr<ExprAST>> for_step
+%nterm <LoopPragmas> loop_pragmas
 
 %nterm <std::pair<std::string, std::unique_ptr<ExprAST>>> varlist_var
 %nterm <std::vector<std::pair<std::string, std::unique_ptr<ExprAST>>>> varlist
@@ -79,11 +141,11 @@
 
 %start axiom;
 axiom: 
-  program { drv.root = std::move($1); }
+  program { drv.end_program(@$); }
 
 program:
-  %empty { $$ = nullptr; }
-  | top ";" program { $$ = std::make_unique<SequenceAST>(std::move($1), std::move($3), @$); }
+  %empty {}
+  | program top ";" { drv.top_level(std::move($2), @2 + @3); }
 
 top:
   %empty { $$ = nullptr; }
@@ -95,17 +157,21 @@ fun_def:
   "def" fun_proto expr { $$ = std::make_unique<FunctionAST>(std::move($2), std::move($3), @$); }
 
 fun_proto:
-  "id" "(" fun_proto_params ")" { $$ = std::make_unique<FunctionPrototypeAST>(std::move($1), std::move($3), @$); }
+  "id" "(" fun_proto_params ")" { $$ = makePrototype($1, $3, @$); }
 
 fun_proto_params:
-  %empty { $$ = std::vector<std::string>(); }
-  | "id" fun_proto_params { $2.insert($2.begin(), std::move($1)); $$ = std::move($2); }
+  %empty { $$ = std::vector<std::pair<std::string, bool>>(); }
+  | "id" fun_proto_params { $2.insert($2.begin(), std::make_pair(std::move($1), false)); $$ = std::move($2); }
+  | "id" "[" "]" fun_proto_params { $4.insert($4.begin(), std::make_pair(std::move($1), true)); $$ = std::move($4); }
 
 fun_ext:
   "extern" fun_proto { $$ = std::move($2); }
 
 %right ":";
 %nonassoc "=";
+%left "or";
+%left "and";
+%precedence "not";
 %nonassoc "<" "<=" ">" ">=" "==" "!=";
 %left "+" "-";
 %left "*" "/";
@@ -123,13 +189,17 @@ expr:
   | expr ">=" expr { $$ = std::make_unique<BinaryExprAST>(BinaryOperator::Gte, std::move($1), std::move($3), @$); }
   | expr "==" expr { $$ = std::make_unique<BinaryExprAST>(BinaryOperator::Eq, std::move($1), std::move($3), @$); }
   | expr "!=" expr { $$ = std::make_unique<BinaryExprAST>(BinaryOperator::Neq, std::move($1), std::move($3), @$); }
+  | expr "and" expr { $$ = std::make_unique<BinaryExprAST>(BinaryOperator::And, std::move($1), std::move($3), @$); }
+  | expr "or" expr { $$ = std::make_unique<BinaryExprAST>(BinaryOperator::Or, std::move($1), std::move($3), @$); }
+  | "not" expr { $$ = std::make_unique<UnaryExprAST>(UnaryOperator::LogicalNot, std::move($2), @$); }
   | "id" "=" expr { $$ = std::make_unique<AssignmentExprAST>($1, std::move($3), @$); }
+  | "id" "[" expr "]" "=" expr { $$ = std::make_unique<ArrayAssignExprAST>($1, std::move($3), std::move($6), @$); }
   | expr ":" expr { $$ = std::make_unique<CompositeExprAST>(std::move($1), std::move($3), @$); }
   | "-" expr %prec UMINUS { $$ = std::make_unique<UnaryExprAST>(UnaryOperator::NumericNeg, std::move($2), @$); }
   | identifier_expr { $$ = std::move($1); }
   | "(" expr ")" { $$ = std::move($2); }
   | "if" expr "then" expr "else" expr "end" { $$ = std::make_unique<IfExprAST>(std::move($2), std::move($4), std::move($6), @$); }
-  | "for" "id" "=" expr "," expr for_step "in" expr "end"
+  | "for" "id" "=" expr "," expr for_step "in" loop_pragmas expr "end"
       {
         $$ = std::make_unique<ForExprAST>(
           std::make_unique<AssignmentExprAST>($2, std::move($4), @4),
@@ -144,11 +214,12 @@ expr:
             ),
             @7
           ),
-          std::move($9),
+          $9,
+          std::move($10),
           @$
         );
       }
-  | "while" expr "in" expr "end" { $$ = std::make_unique<WhileExprAST>(std::move($2), std::move($4), @$); }
+  | "while" expr "in" loop_pragmas expr "end" { $$ = std::make_unique<WhileExprAST>(std::move($2), $4, std::move($5), @$); }
   | "var" varlist "in" expr "end" { $$ = std::make_unique<VarExprAST>(std::move($2), std::move($4), @$); }
 
 varlist:
@@ -158,6 +229,17 @@ varlist:
 varlist_var:
   "id" { $$ = std::make_pair($1, std::make_unique<NumberExprAST>(0, @$)); }
   | "id" "=" expr { $$ = std::make_pair($1, std::move($3)); }
+  | "id" "[" "number" "]"
+      {
+        if (!($3 >= 1 && $3 <= UINT32_MAX) || $3 != (uint32_t) $3)
+          throw yy::parser::syntax_error(@3, "Array size must be a positive integer below 2^32");
+        $$ = std::make_pair($1, std::make_unique<NewArrayExprAST>((uint32_t) $3, @$));
+      }
+
+loop_pragmas:
+  %empty { $$ = LoopPragmas(); }
+  | loop_pragmas "pragma" { applyLoopPragma($1, $2, nullptr, @2); $$ = $1; }
+  | loop_pragmas "pragma(" "number" ")" { applyLoopPragma($1, $2, &$3, @2 + @4); $$ = $1; }
 
 for_step:
   %empty { $$ = std::make_unique<NumberExprAST>(1.0, @$); }
@@ -166,6 +248,8 @@ for_step:
 identifier_expr:
   "id" { $$ = std::make_unique<VariableExprAST>(std::move($1), @$); }
   | "id" "(" opt_expr_list ")" { $$ = std::make_unique<CallExprAST>(std::move($1), std::move($3), @$); }
+  | "id" "[" expr "]" { $$ = std::make_unique<ArrayIndexExprAST>(std::move($1), std::move($3), @$); }
+  | "len" "(" "id" ")" { $$ = std::make_unique<ArrayLengthExprAST>(std::move($3), @$); }
 
 opt_expr_list:
   %empty { $$ = std::vector<std::unique_ptr<ExprAST>>(); }
@@ -181,5 +265,5 @@ expr_list:
 
 void yy::parser::error (const location_type& l, const std::string& m)
 {
-  std::cerr << l << ": " << m << '\n';
+  drv.diagnostics.push_back(drv.describe(l) + ": " + m);
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "kalrt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Room for one printd: "%f" of the largest double takes 316 characters. */
+#define NUMBER_SIZE 330
+
+struct kalrt_buffer kalrt_out = { 0, KALRT_BUFFER_SIZE, { 0 } };
+
+static int line_buffered;
+
+/* Output goes through stdio, so that it stays in order with whatever the host
+ * program prints itself after a flush. */
+static void write_out(void)
+{
+  fwrite(kalrt_out.data, 1, kalrt_out.length, stdout);
+  fflush(stdout);
+  kalrt_out.length = 0;
+}
+
+static void reserve(uint64_t size)
+{
+  if (kalrt_out.length + size > KALRT_BUFFER_SIZE)
+    write_out();
+}
+
+static void append_number(double x)
+{
+  reserve(NUMBER_SIZE);
+  kalrt_out.length += snprintf(kalrt_out.data + kalrt_out.length, NUMBER_SIZE, "%f\n", x);
+}
+
+static void flush_at_exit(void)
+{
+  if (kalrt_out.length > 0)
+    write_out();
+}
+
+__attribute__((constructor)) static void init(void)
+{
+  /* On a terminal, inline appends are disabled so that putchard sees every newline. */
+  line_buffered = isatty(STDOUT_FILENO);
+  if (line_buffered)
+    kalrt_out.limit = 0;
+
+  atexit(flush_at_exit);
+}
+
+/* Only called by inlined code when the buffer is full or line buffered. */
+double putchard(double c)
+{
+  reserve(1);
+  kalrt_out.data[kalrt_out.length++] = (char) c;
+
+  if (line_buffered && (char) c == '\n')
+    write_out();
+  return 0;
+}
+
+double printd(double x)
+{
+  append_number(x);
+
+  if (line_buffered)
+    write_out();
+  return 0;
+}
+
+double printstr(const double *s, int64_t n)
+{
+  for (int64_t i = 0; i < n && s[i] != 0; ++i) {
+    reserve(1);
+    kalrt_out.data[kalrt_out.length++] = (char) s[i];
+  }
+
+  if (line_buffered)
+    write_out();
+  return 0;
+}
+
+double printarray(const double *a, int64_t n)
+{
+  for (int64_t i = 0; i < n; ++i)
+    append_number(a[i]);
+
+  if (line_buffered)
+    write_out();
+  return 0;
+}
+
+double flush(void)
+{
+  write_out();
+  return 0;
+}
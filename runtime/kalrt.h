@@ -0,0 +1,46 @@
+#ifndef KALRT_H
+#define KALRT_H
+
+/* The kalcc runtime: buffered output for Kaleidoscope programs.
+ *
+ * Everything printed goes through one buffer, written to stdout when it is full,
+ * on flush() and at exit.  When stdout is a terminal the buffer is flushed at every
+ * newline instead.  Programs compiled with -runtime append characters to the
+ * buffer inline, so its layout is part of the ABI. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KALRT_BUFFER_SIZE 65536
+
+struct kalrt_buffer {
+  /* Bytes used in data. */
+  uint64_t length;
+  /* putchard may append inline while length < limit; 0 sends every call to the runtime. */
+  uint64_t limit;
+  char data[KALRT_BUFFER_SIZE];
+};
+
+extern struct kalrt_buffer kalrt_out;
+
+/* The Kaleidoscope functions, declared as "extern putchard(c)" and so on.  An
+ * array parameter "a[]" is passed as a pointer and a length. */
+double putchard(double c);
+double printd(double x);
+
+/* Print the characters whose codes are in s, up to the first 0. */
+double printstr(const double *s, int64_t n);
+
+/* Print every element of a like printd. */
+double printarray(const double *a, int64_t n);
+
+double flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !KALRT_H */
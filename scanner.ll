@@ -1,4 +1,4 @@
-%option noyywrap nounput noinput batch debug
+%option reentrant noyywrap nounput noinput batch debug
 
 %{ /* -*- C++ -*- */
 
@@ -14,7 +14,10 @@ yy::parser::symbol_type parseNumber(const std::string &s, const yy::parser::loca
 yy::parser::symbol_type parseKeyword(const std::string &s, const yy::parser::location_type& loc);
 
 // Code run each time a pattern is matched.
-# define YY_USER_ACTION  loc.columns (yyleng);
+# define YY_USER_ACTION                                                   \
+  if ((uint32_t) yyleng > SourceRange::max_offset - loc.end)              \
+    throw yy::parser::syntax_error(loc, "Input larger than 4 GiB");       \
+  loc.end += yyleng;
 %}
 
 blank [ \t\r]
@@ -29,13 +32,17 @@ id [a-zA-Z][a-zA-Z0-9]*
 
 %{
   // A handy shortcut to the location held by the driver.
-  yy::location& loc = drv.location;
+  SourceRange& loc = drv.location;
   // Code run each time yylex is called.
   loc.step ();
 %}
 
 {blank}+   loc.step();
-\n+        loc.lines(yyleng); loc.step();
+\n+        {
+  for (int i = 1; i <= yyleng; ++i)
+    drv.lines.addLine(loc.begin + i);
+  loc.step();
+}
 
 "-"        return yy::parser::make_MINUS(loc);
 "+"        return yy::parser::make_PLUS(loc);
@@ -43,6 +50,8 @@ id [a-zA-Z][a-zA-Z0-9]*
 "/"        return yy::parser::make_SLASH(loc);
 "("        return yy::parser::make_LPAREN(loc);
 ")"        return yy::parser::make_RPAREN(loc);
+"["        return yy::parser::make_LBRACKET(loc);
+"]"        return yy::parser::make_RBRACKET(loc);
 ";"        return yy::parser::make_SEMICOLON(loc);
 ":"        return yy::parser::make_COLON(loc);
 ","        return yy::parser::make_COMMA(loc);
@@ -57,6 +66,8 @@ id [a-zA-Z][a-zA-Z0-9]*
 
 {num}      return parseNumber(yytext, loc);
 {id}       return parseKeyword(yytext, loc);
+"@"{id}"(" return yy::parser::make_PRAGMA_ARGS(std::string(yytext + 1, yyleng - 2), loc);
+"@"{id}    return yy::parser::make_PRAGMA(std::string(yytext + 1), loc);
 
 <<EOF>>    return yy::parser::make_EOF(loc);
 .          {
@@ -80,7 +91,7 @@ yy::parser::symbol_type parseNumber(const std::string &s, const yy::parser::loca
   }
 }
 
-yy::parser::symbol_type parseKeyword(const std::string &s, const yy::location& loc)  {
+yy::parser::symbol_type parseKeyword(const std::string &s, const yy::parser::location_type& loc)  {
        if (s == "def")    return yy::parser::make_DEF(loc);
   else if (s == "extern") return yy::parser::make_EXTERN(loc);
   else if (s == "if")     return yy::parser::make_IF(loc);
@@ -91,24 +102,44 @@ yy::parser::symbol_type parseKeyword(const std::string &s, const yy::location& l
   else if (s == "while")  return yy::parser::make_WHILE(loc);
   else if (s == "in")     return yy::parser::make_IN(loc);
   else if (s == "var")    return yy::parser::make_VAR(loc);
+  else if (s == "and")    return yy::parser::make_AND(loc);
+  else if (s == "or")     return yy::parser::make_OR(loc);
+  else if (s == "not")    return yy::parser::make_NOT(loc);
+  else if (s == "len")    return yy::parser::make_LEN(loc);
   else
-    return yy::parser::make_IDENTIFIER (yytext, loc);
+    return yy::parser::make_IDENTIFIER (s, loc);
 }
 
-void driver::scan_begin()
+bool driver::scan_begin()
 {
-  yy_flex_debug = trace_scanning;
+  FILE* in;
   if (file.empty() || file == "-")
-    yyin = stdin;
-  else if (!(yyin = fopen(file.c_str(), "r")))
+    in = stdin;
+  else if (!(in = fopen(file.c_str(), "r")))
   {
-    std::cerr << "cannot open " << file << ": " << strerror(errno) << '\n';
-    exit(EXIT_FAILURE);
+    diagnostics.push_back("cannot open " + file + ": " + strerror(errno));
+    return false;
   }
+
+  yylex_init(&scanner);
+  yyset_debug(trace_scanning, scanner);
+  yyset_in(in, scanner);
+  return true;
 }
 
+void driver::scan_begin_string(llvm::StringRef source)
+{
+  yylex_init(&scanner);
+  yyset_debug(trace_scanning, scanner);
+  yy_scan_bytes(source.data(), source.size(), scanner);
+}
 
 void driver::scan_end()
 {
-  fclose (yyin);
+  FILE* in = yyget_in(scanner);
+  if (in && in != stdin)
+    fclose(in);
+
+  yylex_destroy(scanner);
+  scanner = nullptr;
 }
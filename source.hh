@@ -0,0 +1,67 @@
+#ifndef SOURCE_HH
+#define SOURCE_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// The location of a node or token: a range [begin, end) of byte offsets in
+// the file being compiled.  Lines and columns are only computed from the
+// driver's LineTable when a message needs them.  Offsets are 32 bits, so the
+// scanner rejects input past max_offset rather than letting them wrap.
+struct SourceRange {
+  static const uint32_t max_offset = UINT32_MAX;
+
+  uint32_t begin = 0, end = 0;
+
+  SourceRange() = default;
+  SourceRange(uint32_t begin, uint32_t end) : begin(begin), end(end) {}
+
+  // Start a new token where the previous one ended.
+  void step() { begin = end; }
+};
+
+// The range spanning from the start of a to the end of b.
+inline SourceRange operator+(const SourceRange& a, const SourceRange& b) {
+  return SourceRange(a.begin, b.end);
+}
+
+// Used by the parser traces.
+inline std::ostream& operator<<(std::ostream& out, const SourceRange& range) {
+  return out << "@" << range.begin << "-" << range.end;
+}
+
+struct SourcePosition {
+  unsigned line, column;
+};
+
+// The offsets at which each line of a file starts, filled in by the scanner.
+class LineTable {
+  // starts[i] is the offset of line first + i.
+  std::vector<uint32_t> starts = { 0 };
+  unsigned first = 1;
+
+public:
+  void clear() { starts.assign(1, 0); first = 1; }
+  void addLine(uint32_t start) { starts.push_back(start); }
+
+  // Drop the lines ending before offset, which can no longer be resolved.
+  // Used when streaming, so that the table does not grow with the input.
+  void discardBefore(uint32_t offset) {
+    auto line = std::upper_bound(starts.begin(), starts.end(), offset) - 1;
+    first += line - starts.begin();
+    starts.erase(starts.begin(), line);
+  }
+
+  // 1-based line and column of offset, or line 0 if its line was discarded.
+  SourcePosition resolve(uint32_t offset) const {
+    auto next = std::upper_bound(starts.begin(), starts.end(), offset);
+    if (next == starts.begin())
+      return { 0, 0 };
+    unsigned index = next - starts.begin();
+    return { first + index - 1, offset - starts[index - 1] + 1 };
+  }
+};
+
+#endif // !SOURCE_HH
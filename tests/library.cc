@@ -0,0 +1,94 @@
+// Tests of the library API in kalcc.hh, built against libkalcc.a by make check.
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "kalcc.hh"
+
+static std::atomic<int> failures(0);
+
+static void expect(bool condition, const std::string& what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED %s\n", what.c_str());
+    ++failures;
+  }
+}
+
+static bool contains(const std::string& text, const std::string& part) {
+  return text.find(part) != std::string::npos;
+}
+
+static void testValid() {
+  kalcc::Options options;
+  options.name = "valid.k";
+  kalcc::Result r = kalcc::compile("def twice(x) x * 2;\ntwice(3);\n", options);
+
+  expect(r.ok(), "valid source compiles");
+  expect(r.diagnostics.empty(), "valid source has no diagnostics");
+  expect(contains(r.ir(), "define double @twice(double"), "IR defines twice");
+  expect(contains(r.ir(), "valid.k"), "module named after options.name");
+  expect(!r.bitcode().empty(), "bitcode is written");
+}
+
+static void testSyntaxError() {
+  kalcc::Options options;
+  options.name = "syntax.k";
+  kalcc::Result r = kalcc::compile("def f(x)\n  x +;\n", options);
+
+  expect(!r.ok(), "syntax error fails");
+  expect(r.ir().empty(), "no IR after a syntax error");
+  expect(r.diagnostics.size() == 1 && contains(r.diagnostics[0], "syntax.k:2.6"),
+         "syntax error reported at syntax.k:2.6");
+}
+
+static void testCodegenError() {
+  kalcc::Result r = kalcc::compile("def f(x)\n  x + y;\n");
+
+  expect(!r.ok(), "unknown variable fails");
+  expect(r.diagnostics.size() == 1 && contains(r.diagnostics[0], "Ln 2 Col 7")
+           && contains(r.diagnostics[0], "Unknown variable name: y"),
+         "unknown variable reported at line 2");
+}
+
+// Every thread compiles its own programs, valid or with an error on a line
+// of its own: results and locations must not leak between compilations.
+static void compileMany(int thread) {
+  std::string name = "f" + std::to_string(thread);
+
+  for (int i = 0; i < 50; ++i) {
+    if (i % 2 == 0) {
+      kalcc::Result r = kalcc::compile("def " + name + "(x) x + " + std::to_string(i) + ";\n" + name + "(1);\n");
+      expect(r.ok() && r.diagnostics.empty(), "thread " + std::to_string(thread) + " compiles");
+      expect(contains(r.ir(), "define double @" + name + "(double"), "thread " + std::to_string(thread) + " gets its own IR");
+      continue;
+    }
+
+    kalcc::Options options;
+    options.name = name + ".k";
+    kalcc::Result r = kalcc::compile(std::string(thread + 1, '\n') + "def (x) x;\n", options);
+    std::string where = options.name + ":" + std::to_string(thread + 2) + ".5";
+    expect(!r.ok() && r.diagnostics.size() == 1 && contains(r.diagnostics[0], where),
+           "thread " + std::to_string(thread) + " reports its error at " + where);
+  }
+}
+
+static void testConcurrent() {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i)
+    threads.emplace_back(compileMany, i);
+  for (auto& thread : threads)
+    thread.join();
+}
+
+int main() {
+  testValid();
+  testSyntaxError();
+  testCodegenError();
+  testConcurrent();
+
+  if (failures > 0)
+    return 1;
+  std::printf("ok     library\n");
+  return 0;
+}
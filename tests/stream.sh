@@ -0,0 +1,25 @@
+#!/bin/bash
+# Compile samples with -stream, with and without -runtime, and check that opt
+# accepts the output.
+#
+# Usage: tests/stream.sh [sample.k...]   (default: tests/array.k tests/runtime.k)
+# Environment: KALCC (default ./kalcc)
+
+LLVM_VERSION=14
+
+KALCC=${KALCC:-./kalcc}
+SAMPLES=${*:-tests/array.k tests/runtime.k}
+
+status=0
+for sample in $SAMPLES; do
+  for flags in "-stream" "-stream -runtime"; do
+    if $KALCC $sample $flags | opt-$LLVM_VERSION -verify -disable-output; then
+      echo "ok     $sample $flags"
+    else
+      echo "FAILED $sample $flags"
+      status=1
+    fi
+  done
+done
+
+exit $status
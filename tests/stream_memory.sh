@@ -0,0 +1,44 @@
+#!/bin/bash
+# Stream two generated inputs of different sizes and check that peak memory
+# grows by less than LIMIT bytes per function between them.
+#
+# Usage: tests/stream_memory.sh
+# Environment: KALCC (default ./kalcc), LIMIT (default 512)
+
+KALCC=${KALCC:-./kalcc}
+LIMIT=${LIMIT:-512}
+SMALL=5000
+LARGE=40000
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+# Functions with a loop carrying a pragma, called once each.
+generate() {
+  for ((i = 0; i < $1; ++i)); do
+    echo "def f$i(x) var s in for i = 0, i < x in @unroll(4) s = s + i end : s end;"
+    echo "f$i($i);"
+  done > "$2"
+}
+
+# Peak resident set size of kalcc streaming $1, in KiB.
+peak_rss() {
+  python3 -c '
+import resource, subprocess, sys
+subprocess.run(sys.argv[1:], stdout=subprocess.DEVNULL, check=True)
+print(resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss)' $KALCC "$1" -stream
+}
+
+generate $SMALL "$dir/small.k"
+generate $LARGE "$dir/large.k"
+
+small=$(peak_rss "$dir/small.k") || exit 1
+large=$(peak_rss "$dir/large.k") || exit 1
+per_function=$(( (large - small) * 1024 / (LARGE - SMALL) ))
+
+echo "$SMALL functions: $small KiB, $LARGE functions: $large KiB, $per_function bytes per function"
+if [ $per_function -ge $LIMIT ]; then
+  echo "FAILED memory grows by $per_function bytes per function (limit $LIMIT)"
+  exit 1
+fi
+echo "ok"
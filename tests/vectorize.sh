@@ -0,0 +1,38 @@
+#!/bin/bash
+# Optimize tests/array.k with opt and check that its element loops are
+# vectorized, while the reduction in sum, which has no @vectorize, is not.
+#
+# Usage: tests/vectorize.sh
+# Environment: KALCC (default ./kalcc)
+
+LLVM_VERSION=14
+
+KALCC=${KALCC:-./kalcc}
+SAMPLE=tests/array.k
+
+remarks=$(mktemp)
+trap 'rm -f "$remarks"' EXIT
+
+$KALCC $SAMPLE | opt-$LLVM_VERSION -O2 -pass-remarks-output="$remarks" -disable-output || exit 1
+
+# The function of every loop the vectorizer reports as vectorized.
+vectorized=$(grep -A3 '^Name: *Vectorized$' "$remarks" | sed -n 's/^Function: *//p' | sort -u)
+
+status=0
+for function in fill axpy; do
+  if grep -qx "$function" <<< "$vectorized"; then
+    echo "ok     $function vectorized"
+  else
+    echo "FAILED $function not vectorized"
+    status=1
+  fi
+done
+
+if grep -qx sum <<< "$vectorized"; then
+  echo "FAILED sum vectorized without @vectorize"
+  status=1
+else
+  echo "ok     sum not vectorized"
+fi
+
+exit $status
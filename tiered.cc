@@ -0,0 +1,372 @@
+#include "tiered.hh"
+#include "driver.hh"
+#include <atomic>
+#include <cstdio>
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
+
+static void check(llvm::Error err) {
+  if (err)
+    throw std::runtime_error(llvm::toString(std::move(err)));
+}
+
+template <typename T>
+static T check(llvm::Expected<T> value) {
+  if (!value)
+    throw std::runtime_error(llvm::toString(value.takeError()));
+  return std::move(*value);
+}
+
+// Marks the modules holding tier 2 code.
+static const char* const TIER2_FLAG = "kalcc.tier2";
+
+// Tier 2 modules get the optimizing code generator, everything else the fast one.
+class TierCompiler : public llvm::orc::IRCompileLayer::IRCompiler {
+  llvm::orc::JITTargetMachineBuilder jtmb;
+
+public:
+  TierCompiler(llvm::orc::JITTargetMachineBuilder jtmb)
+    : IRCompiler(llvm::orc::irManglingOptionsFromTargetOptions(jtmb.getOptions())),
+      jtmb(std::move(jtmb)) {}
+
+  llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(llvm::Module& M) override {
+    llvm::orc::JITTargetMachineBuilder builder = this->jtmb;
+    builder.setCodeGenOptLevel(M.getModuleFlag(TIER2_FLAG) ? llvm::CodeGenOpt::Aggressive : llvm::CodeGenOpt::None);
+
+    auto TM = builder.createTargetMachine();
+    if (!TM)
+      return TM.takeError();
+    return llvm::orc::SimpleCompiler(**TM)(M);
+  }
+};
+
+static void optimize(llvm::Module& M, llvm::TargetMachine* TM) {
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  llvm::PassBuilder PB(TM);
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3).run(M, MAM);
+}
+
+
+TieredEngine::TieredEngine(driver& drv)
+  : drv(drv) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  auto jtmb = check(llvm::orc::JITTargetMachineBuilder::detectHost());
+  this->jit = check(llvm::orc::LLJITBuilder()
+    .setJITTargetMachineBuilder(jtmb)
+    .setCompileFunctionCreator([](llvm::orc::JITTargetMachineBuilder jtmb)
+        -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+      return std::make_unique<TierCompiler>(std::move(jtmb));
+    })
+    .create());
+
+  // Externs are looked up in the running process; tier 0 code calls back into tierUp.
+  llvm::orc::JITDylib& lib = this->jit->getMainJITDylib();
+  lib.addGenerator(check(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+    this->jit->getDataLayout().getGlobalPrefix())));
+  check(lib.define(llvm::orc::absoluteSymbols({
+    { this->jit->mangleAndIntern("__kalcc_tier_up"),
+      llvm::JITEvaluatedSymbol(llvm::pointerToJITTargetAddress(&TieredEngine::tierUp), llvm::JITSymbolFlags::Exported) }
+  })));
+
+  jtmb.setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+  this->optimizing_machine = check(jtmb.createTargetMachine());
+}
+
+TieredEngine::~TieredEngine() {
+  this->stop();
+}
+
+
+/* CODE GENERATION */
+
+llvm::Value* TieredEngine::loadCallee(driver& drv, llvm::Function* callee) {
+  // The slot is defined by the tier 0 module, and only declared by the others.
+  std::string name = callee->getName().str() + ".slot";
+  llvm::Constant* slot = drv.llvmModule->getOrInsertGlobal(name, callee->getType());
+
+  llvm::LoadInst* code = drv.llvmIRBuilder->CreateLoad(callee->getType(), slot, callee->getName() + "_code");
+  code->setAtomic(llvm::AtomicOrdering::Acquire);
+  return code;
+}
+
+TieredEngine::FunctionState& TieredEngine::getState(const std::string& name, FunctionAST* ast) {
+  FunctionState*& state = this->function_index[name];
+  if (!state) {
+    this->functions.emplace_back();
+    state = &this->functions.back();
+    state->name = name;
+  }
+
+  if (ast)
+    state->ast = ast;
+  return *state;
+}
+
+// Add one to *counter and return the new count.  The JIT runs in this process:
+// the counters live in the engine.  Only the program's thread writes them, so
+// monotonic accesses are enough for the worker to read them.
+static llvm::Value* emitIncrement(llvm::IRBuilder<>& builder, std::atomic<uint64_t>* counter) {
+  llvm::Type* i64 = builder.getInt64Ty();
+  llvm::Value* address = builder.CreateIntToPtr(builder.getInt64(reinterpret_cast<uintptr_t>(counter)), i64->getPointerTo());
+
+  llvm::LoadInst* load = builder.CreateLoad(i64, address);
+  load->setAtomic(llvm::AtomicOrdering::Monotonic);
+  llvm::Value* count = builder.CreateAdd(load, builder.getInt64(1));
+  builder.CreateStore(count, address)->setAtomic(llvm::AtomicOrdering::Monotonic);
+  return count;
+}
+
+// Top-level expressions run once: replacing their code would not help.
+static bool isCounted(driver& drv, llvm::Function* F) {
+  return drv.tier == 0 && !F->getName().startswith("__anon_expr");
+}
+
+void TieredEngine::countCall(driver& drv, llvm::Function* F, FunctionAST& function) {
+  if (!isCounted(drv, F))
+    return;
+
+  FunctionState& state = this->getState(F->getName().str(), &function);
+  this->incrementCounter(drv, F, &state.calls, call_threshold, state);
+}
+
+void TieredEngine::countLoop(driver& drv, llvm::Function* F, const SourceRange& loop, llvm::BasicBlock* exitBlock) {
+  if (drv.tier == 2) {
+    // All tier 0 code is generated before the worker starts: the index no longer changes.
+    auto function = this->function_index.find(F->getName().str());
+    if (function == this->function_index.end())
+      return;
+
+    auto it = function->second->loops.find(loop.begin);
+    if (it == function->second->loops.end())
+      return;
+
+    uint64_t iterations = it->second.back_edges.load(std::memory_order_relaxed);
+    uint64_t exits = it->second.exits.load(std::memory_order_relaxed);
+    if (iterations == 0 && exits == 0)
+      return;
+
+    // Every branch of the condition leaving the loop gets the counts of the whole loop.
+    llvm::MDBuilder weights(*drv.llvmContext);
+    for (llvm::BasicBlock* pred : llvm::predecessors(exitBlock)) {
+      llvm::BranchInst* branch = llvm::dyn_cast<llvm::BranchInst>(pred->getTerminator());
+      if (!branch || !branch->isConditional())
+        continue;
+
+      if (branch->getSuccessor(0) == exitBlock)
+        branch->setMetadata(llvm::LLVMContext::MD_prof, weights.createBranchWeights(exits, iterations));
+      else
+        branch->setMetadata(llvm::LLVMContext::MD_prof, weights.createBranchWeights(iterations, exits));
+    }
+    return;
+  }
+
+  if (!isCounted(drv, F))
+    return;
+
+  FunctionState& state = this->getState(F->getName().str(), nullptr);
+  LoopState& counts = state.loops[loop.begin];
+
+  // Nothing has been emitted in exitBlock yet: the exit is counted first.
+  llvm::IRBuilder<> exitBuilder(exitBlock);
+  emitIncrement(exitBuilder, &counts.exits);
+
+  this->incrementCounter(drv, F, &counts.back_edges, back_edge_threshold, state);
+}
+
+void TieredEngine::incrementCounter(driver& drv, llvm::Function* F, std::atomic<uint64_t>* counter, uint64_t threshold, FunctionState& state) {
+  llvm::IRBuilder<>& builder = *drv.llvmIRBuilder;
+  llvm::Type* ptr = builder.getInt8PtrTy();
+
+  llvm::Value* count = emitIncrement(builder, counter);
+
+  llvm::BasicBlock* hotBB = llvm::BasicBlock::Create(*drv.llvmContext, "tier_up", F);
+  llvm::BasicBlock* mergeBB = llvm::BasicBlock::Create(*drv.llvmContext, "counted", F);
+  builder.CreateCondBr(
+    builder.CreateICmpEQ(count, builder.getInt64(threshold)), hotBB, mergeBB,
+    llvm::MDBuilder(*drv.llvmContext).createBranchWeights(1, threshold));
+
+  builder.SetInsertPoint(hotBB);
+  llvm::FunctionCallee tierUp = drv.llvmModule->getOrInsertFunction("__kalcc_tier_up", builder.getVoidTy(), ptr, ptr);
+  builder.CreateCall(tierUp, {
+    builder.CreateIntToPtr(builder.getInt64(reinterpret_cast<uintptr_t>(this)), ptr),
+    builder.CreateIntToPtr(builder.getInt64(reinterpret_cast<uintptr_t>(&state)), ptr)
+  });
+  builder.CreateBr(mergeBB);
+
+  builder.SetInsertPoint(mergeBB);
+}
+
+
+/* EXECUTION */
+
+void TieredEngine::run(RootAST& root) {
+  llvm::Module& M = *this->drv.llvmModule;
+  M.setDataLayout(this->jit->getDataLayout());
+  M.setTargetTriple(this->jit->getTargetTriple().str());
+
+  this->drv.tiered = this;
+  root.codegen(this->drv, 0);
+  this->drv.tiered = nullptr;
+
+  std::vector<std::string> entry_points;
+  for (llvm::Function& F : M) {
+    if (!F.getReturnType()->isDoubleTy())
+      continue;
+
+    std::vector<llvm::Type::TypeID> params;
+    for (llvm::Argument& arg : F.args())
+      params.push_back(arg.getType()->getTypeID());
+
+    this->declarations.emplace_back(F.getName().str(), std::move(params));
+    if (!F.isDeclaration() && F.getName().startswith("__anon_expr"))
+      entry_points.push_back(F.getName().str());
+  }
+
+  // Every slot starts on the tier 0 code (or the extern) of its function.
+  for (llvm::GlobalVariable& G : M.globals())
+    if (G.isDeclaration() && G.getName().endswith(".slot"))
+      G.setInitializer(M.getFunction(G.getName().drop_back(5)));
+
+  this->drv.llvmIRBuilder.reset();
+  check(this->jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(this->drv.llvmModule), std::move(this->drv.llvmContext))));
+
+  this->worker = std::thread(&TieredEngine::workerLoop, this);
+
+  for (auto& name : entry_points) {
+    auto entry = llvm::jitTargetAddressToFunction<double (*)()>(check(this->jit->lookup(name)).getAddress());
+    double value = entry();
+    if (this->drv.flush_output)
+      this->drv.flush_output();
+    std::printf("%f\n", value);
+  }
+
+  this->stop();
+}
+
+void TieredEngine::stop() {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+  }
+  this->wake.notify_one();
+
+  if (this->worker.joinable())
+    this->worker.join();
+}
+
+void TieredEngine::tierUp(TieredEngine* engine, FunctionState* state) {
+  std::lock_guard<std::mutex> lock(engine->mutex);
+  if (state->queued || engine->stopping || !state->ast)
+    return;
+
+  state->queued = true;
+  engine->queue.push_back(state);
+  engine->wake.notify_one();
+}
+
+void TieredEngine::workerLoop() {
+  for (;;) {
+    FunctionState* state;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->wake.wait(lock, [this] { return this->stopping || !this->queue.empty(); });
+      if (this->stopping)
+        return;
+
+      state = this->queue.front();
+      this->queue.pop_front();
+    }
+
+    try {
+      this->recompile(*state);
+    } catch (std::exception& e) {
+      // The function just stays at tier 0.
+      if (this->drv.trace_codegen)
+        llvm::errs() << "[Tier 2 failed \"" << state->name << "\"]  " << e.what() << "\n";
+    }
+  }
+}
+
+void TieredEngine::recompile(FunctionState& state) {
+  // A private driver: the AST is only read, and LLVM contexts are not shared between threads.
+  driver tier2;
+  tier2.const_eval = false;
+  tier2.runtime_io = this->drv.runtime_io;
+  tier2.init_codegen();
+  tier2.tiered = this;
+  tier2.tier = 2;
+
+  llvm::Module& M = *tier2.llvmModule;
+  M.setDataLayout(this->jit->getDataLayout());
+  M.setTargetTriple(this->jit->getTargetTriple().str());
+  M.addModuleFlag(llvm::Module::Warning, TIER2_FLAG, 1);
+
+  llvm::Type* doubleTy = llvm::Type::getDoubleTy(*tier2.llvmContext);
+  for (auto& decl : this->declarations) {
+    if (decl.first == state.name)
+      continue;
+
+    std::vector<llvm::Type*> params;
+    for (llvm::Type::TypeID id : decl.second) {
+      if (id == llvm::Type::PointerTyID)
+        params.push_back(doubleTy->getPointerTo());
+      else if (id == llvm::Type::IntegerTyID)
+        params.push_back(llvm::Type::getInt64Ty(*tier2.llvmContext));
+      else
+        params.push_back(doubleTy);
+    }
+
+    llvm::Function::Create(llvm::FunctionType::get(doubleTy, params, false), llvm::Function::ExternalLinkage, decl.first, M);
+  }
+
+  llvm::Function* F = llvm::cast<llvm::Function>(state.ast->codegen(tier2, 0));
+
+  // The tier 0 definition keeps its name.
+  std::string name = state.name + ".tier2";
+  F->setName(name);
+
+  // The counters are still being updated by the running code: a stale value is fine.
+  uint64_t calls = state.calls.load(std::memory_order_relaxed);
+  F->setEntryCount(calls);
+
+  optimize(M, this->optimizing_machine.get());
+
+  tier2.llvmIRBuilder.reset();
+  check(this->jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(tier2.llvmModule), std::move(tier2.llvmContext))));
+
+  llvm::JITTargetAddress code = check(this->jit->lookup(name)).getAddress();
+
+  // Functions that are never called from compiled code have no slot.
+  auto slot = this->jit->lookup(state.name + ".slot");
+  if (!slot) {
+    llvm::consumeError(slot.takeError());
+    return;
+  }
+
+  llvm::jitTargetAddressToPointer<std::atomic<llvm::JITTargetAddress>*>(slot->getAddress())->store(code, std::memory_order_release);
+
+  if (this->drv.trace_codegen) {
+    uint64_t iterations = 0;
+    for (auto& loop : state.loops)
+      iterations += loop.second.back_edges.load(std::memory_order_relaxed);
+    llvm::errs() << "[Tier 2 \"" << state.name << "\"]  after " << calls << " calls, " << iterations << " loop iterations\n";
+  }
+}
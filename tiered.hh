@@ -0,0 +1,89 @@
+#ifndef TIERED_HH
+#define TIERED_HH
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Target/TargetMachine.h"
+#include "ast.hh"
+
+// Runs the program with -tiered: everything is first JIT-compiled at O0 with
+// call and loop counters.  Functions crossing a threshold are compiled again
+// at O3 on a background thread, using the counts as profile data, and their
+// slot, through which every call is made, is switched to the new code.
+class TieredEngine {
+public:
+  // A function reaches tier 2 after this many calls, or this many iterations of one of its loops.
+  static const uint64_t call_threshold = 1000;
+  static const uint64_t back_edge_threshold = 10000;
+
+  // Code generation hooks, used by the AST when drv.tiered is set.
+  llvm::Value* loadCallee(driver& drv, llvm::Function* callee);
+  void countCall(driver& drv, llvm::Function* F, FunctionAST& function);
+  // Called at the end of a loop body, before the back edge; exitBlock is where the loop exits to.
+  void countLoop(driver& drv, llvm::Function* F, const SourceRange& loop, llvm::BasicBlock* exitBlock);
+
+  explicit TieredEngine(driver& drv);
+  ~TieredEngine();
+
+  // Compile the whole program at tier 0 and run its top-level expressions in
+  // order, printing their values.  Errors are thrown as std::runtime_error.
+  void run(RootAST& root);
+
+private:
+  // The counters are updated by the tier 0 code, and read by the worker thread.
+  struct LoopState {
+    std::atomic<uint64_t> back_edges{0}, exits{0};
+  };
+
+  struct FunctionState {
+    std::string name;
+    FunctionAST* ast = nullptr;
+
+    std::atomic<uint64_t> calls{0};
+
+    // By the offset of each loop, which tier 2 code generation finds again.
+    std::map<uint32_t, LoopState> loops;
+
+    bool queued = false;
+  };
+
+  driver& drv;
+  std::unique_ptr<llvm::orc::LLJIT> jit;
+  std::unique_ptr<llvm::TargetMachine> optimizing_machine;
+
+  // Stable addresses: tier 0 code refers to them directly.
+  std::deque<FunctionState> functions;
+  std::map<std::string, FunctionState*> function_index;
+
+  // Name and parameter types of every function of the program, declared in each tier 2
+  // module: doubles, or the double* and i64 passing an array.
+  std::vector<std::pair<std::string, std::vector<llvm::Type::TypeID>>> declarations;
+
+  std::thread worker;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<FunctionState*> queue;
+  bool stopping = false;
+
+  FunctionState& getState(const std::string& name, FunctionAST* ast);
+  void incrementCounter(driver& drv, llvm::Function* F, std::atomic<uint64_t>* counter, uint64_t threshold, FunctionState& state);
+
+  // Called by tier 0 code when a counter reaches its threshold.
+  static void tierUp(TieredEngine* engine, FunctionState* state);
+
+  void workerLoop();
+  void stop();
+  void recompile(FunctionState& state);
+};
+
+#endif // !TIERED_HH